@@ -0,0 +1,125 @@
+#include "autopilot.h"
+#include "utils.h"
+#include <stdio.h>
+
+// Empty cells kept between the head and the tail when cutting across the cycle
+constexpr uint64_t _SNK_AUTOPILOT_SHORTCUT_SLACK = 3;
+
+void _SNK_Autopilot_setOrder(SNK_Autopilot* autopilot, const bool is_transposed, const int64_t line,
+                             const int64_t column, const uint32_t index) {
+    const int64_t x = is_transposed ? line : column;
+    const int64_t y = is_transposed ? column : line;
+
+    autopilot->_order[y * autopilot->_grid.x + x] = index;
+}
+
+// Walks every line (a row, or a column when transposed) completely, then steps to the next line. Line i is
+// walked in direction d_i, so the next line starts d_i cells before where line i did. The walk closes into a
+// cycle when the sum of all d_i is a multiple of the line length.
+void _SNK_Autopilot_buildCycle(SNK_Autopilot* autopilot) {
+    const SNK_IVec2 grid = autopilot->_grid;
+
+    const bool    is_transposed = grid.y % 2 != 0 && (grid.x % 2 == 0 || grid.x > grid.y);
+    const int64_t lines         = is_transposed ? grid.x : grid.y;
+    const int64_t length        = is_transposed ? grid.y : grid.x;
+
+    // An even line count alternates directions. An odd one has an odd length no longer than the count, so
+    // (lines - length) / 2 forward lines and the rest backwards sum up to exactly -length.
+    const int64_t forward_lines = lines % 2 == 0 ? -1 : (lines - length) / 2;
+
+    int64_t  start = 0;
+    uint32_t index = 0;
+
+    for (int64_t line = 0; line < lines; line++) {
+        const bool    is_forward = forward_lines < 0 ? line % 2 == 0 : line < forward_lines;
+        const int64_t step       = is_forward ? 1 : -1;
+
+        for (int64_t i = 0; i < length; i++)
+            _SNK_Autopilot_setOrder(autopilot, is_transposed, line, SNK_wrap(start + step * i, 0, length), index++);
+
+        start = SNK_wrap(start + step * (length - 1), 0, length);
+    }
+
+    ASSERT(start == 0);
+}
+
+SNK_Autopilot SNK_Autopilot_new(const SNK_IVec2 grid) {
+    ASSERT(grid.x >= 2 && grid.y >= 2);
+    ASSERT(grid.x * grid.y <= UINT32_MAX);
+
+    uint32_t* order = malloc((size_t)(grid.x * grid.y) * sizeof(uint32_t));
+
+    if (order == nullptr)
+        SNK_crash("Failed to allocate memory for autopilot");
+
+    SNK_Autopilot autopilot = {
+        ._grid  = grid,
+        ._order = order,
+    };
+
+    _SNK_Autopilot_buildCycle(&autopilot);
+
+    return autopilot;
+}
+
+uint64_t _SNK_Autopilot_orderOf(const SNK_Autopilot* autopilot, const SNK_Game* game, const SNK_IVec2 pos) {
+    return autopilot->_order[SNK_Game_cellIndex(game, pos)];
+}
+
+SNK_GameInput SNK_Autopilot_input(const SNK_Autopilot* autopilot, const SNK_Game* game) {
+    ASSERT(autopilot != nullptr);
+    ASSERT(game != nullptr);
+    ASSERT(SNK_IVec2_eq(autopilot->_grid, game->grid));
+
+    const uint64_t cells     = (uint64_t)(game->grid.x * game->grid.y);
+    const size_t   body_size = SNK_Ring_size(&game->snake_body);
+    const uint64_t head      = _SNK_Autopilot_orderOf(autopilot, game, game->snake_head);
+    const uint64_t food      = _SNK_Autopilot_orderOf(autopilot, game, game->food);
+
+    uint64_t tail = head;
+
+    if (body_size != 0)
+        tail = _SNK_Autopilot_orderOf(autopilot, game, *(SNK_IVec2*)SNK_Ring_at(&game->snake_body, body_size - 1));
+
+    const uint64_t length       = body_size + 1 + game->pending_growth;
+    const uint64_t to_food      = (food - head + cells) % cells;
+    const uint64_t to_tail      = tail == head ? cells : (tail - head + cells) % cells;
+    const uint64_t tail_reserve = game->pending_growth + _SNK_AUTOPILOT_SHORTCUT_SLACK;
+
+    // Shortcuts stay strictly inside the free stretch of the cycle in front of the head, so following the
+    // cycle afterwards can never run into the body. Once the snake covers half the grid they are not worth it.
+    uint64_t max_jump = 1;
+
+    if (length * 2 < cells && to_tail > tail_reserve + 1)
+        max_jump = to_food < to_tail - tail_reserve ? to_food : to_tail - tail_reserve;
+
+    SNK_Direction best      = game->direction;
+    uint64_t      best_jump = 0;
+
+    for (SNK_Direction direction = SNK_Direction_Up; direction <= SNK_Direction_Right; direction++) {
+        const SNK_IVec2 next = SNK_Direction_move(game->snake_head, direction);
+
+        if (SNK_Game_isOccupied(game, next))
+            continue;
+
+        const SNK_IVec2 wrapped = {SNK_wrap(next.x, 0, game->grid.x), SNK_wrap(next.y, 0, game->grid.y)};
+        const uint64_t  jump    = (_SNK_Autopilot_orderOf(autopilot, game, wrapped) - head + cells) % cells;
+
+        if (jump <= max_jump && jump > best_jump) {
+            best      = direction;
+            best_jump = jump;
+        }
+    }
+
+    return SNK_GameInput_fromDirection(best);
+}
+
+void SNK_Autopilot_free(SNK_Autopilot* autopilot) {
+    ASSERT(autopilot != nullptr);
+
+    if (autopilot->_order != nullptr) {
+        free(autopilot->_order);
+    }
+
+    *autopilot = (SNK_Autopilot){};
+}
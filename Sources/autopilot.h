@@ -0,0 +1,18 @@
+#pragma once
+
+#include "game.h"
+#include <stdint.h>
+
+// Steers along a Hamiltonian cycle of the (wrapping) grid, taking shortcuts towards the food while the snake
+// is short enough for them to be safe. The cycle is built once, every decision after that is constant time.
+typedef struct {
+    SNK_IVec2 _grid;
+    // Index along the cycle of every cell
+    uint32_t* _order;
+} SNK_Autopilot;
+
+SNK_Autopilot SNK_Autopilot_new(SNK_IVec2 grid);
+
+SNK_GameInput SNK_Autopilot_input(const SNK_Autopilot* autopilot, const SNK_Game* game);
+
+void SNK_Autopilot_free(SNK_Autopilot* autopilot);
@@ -0,0 +1,292 @@
+#include "autopilot.h"
+#include "game.h"
+#include "histogram.h"
+#include "rand.h"
+#include "record.h"
+#include "timer.h"
+#include "utils.h"
+#include <stdio.h>
+
+typedef struct {
+    uint64_t  ticks;
+    uint64_t  games;
+    SNK_IVec2 grid;
+    uint64_t  seed;
+    float     delta_time;
+    bool      autopilot;
+    // Recording to play back instead of the synthetic player
+    const char* replay_path;
+} _SNK_BenchOptions;
+
+void _SNK_Bench_usage() {
+    printf("Usage: snake_bench [--ticks N] [--games N] [--grid WxH] [--seed S] [--realtime] [--autopilot]\n"
+           "       snake_bench --replay PATH\n"
+           "--ticks N - stop after N ticks (default 1000000 unless --games is given)\n"
+           "--games N - stop after N finished games\n"
+           "--grid WxH - grid size in cells (default 73x41, a 1080p screen at scale 26)\n"
+           "--seed S - seed of the first game, game i uses S + i (default random)\n"
+           "--realtime - advance ticks by SNK_DELTA_TIME instead of one move per tick\n"
+           "--autopilot - play with the autopilot, which fills the board, instead of the synthetic player\n"
+           "--replay PATH - play back a recording made with 'snake record', using its grid, seed and delta time\n");
+}
+
+bool _SNK_Bench_parseGrid(const char* str, SNK_IVec2* out) {
+    char buf[64];
+
+    if (strlen(str) >= sizeof(buf))
+        return false;
+
+    strcpy(buf, str);
+
+    char* delim = strchr(buf, 'x');
+
+    if (delim == nullptr)
+        return false;
+
+    *delim = '\0';
+
+    uint64_t width  = 0;
+    uint64_t height = 0;
+
+    if (!SNK_parseU64(buf, &width) || !SNK_parseU64(delim + 1, &height))
+        return false;
+
+    // Checked by division, the product of two huge sides wraps around to something small
+    if (width < 2 || height < 2 || height > UINT32_MAX / width)
+        return false;
+
+    *out = (SNK_IVec2){(int64_t)width, (int64_t)height};
+
+    return true;
+}
+
+bool _SNK_Bench_parseArgs(const int argc, char** argv, _SNK_BenchOptions* options) {
+    *options = (_SNK_BenchOptions){
+        .ticks       = 0,
+        .games       = 0,
+        .grid        = {73, 41},
+        .seed        = SNK_Rand_kernelSeed(),
+        .delta_time  = 1.0f,
+        .autopilot   = false,
+        .replay_path = nullptr,
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg   = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (strcmp(arg, "--realtime") == 0) {
+            options->delta_time = SNK_DELTA_TIME;
+
+            continue;
+        }
+
+        if (strcmp(arg, "--autopilot") == 0) {
+            options->autopilot = true;
+
+            continue;
+        }
+
+        if (value == nullptr) {
+            printf("snake_bench: '%s' is unknown or misses its value\n", arg);
+
+            return false;
+        }
+
+        i++;
+
+        bool is_valid = false;
+
+        if (strcmp(arg, "--ticks") == 0) {
+            is_valid = SNK_parseU64(value, &options->ticks) && options->ticks != 0;
+        } else if (strcmp(arg, "--games") == 0) {
+            is_valid = SNK_parseU64(value, &options->games) && options->games != 0;
+        } else if (strcmp(arg, "--grid") == 0) {
+            is_valid = _SNK_Bench_parseGrid(value, &options->grid);
+        } else if (strcmp(arg, "--seed") == 0) {
+            is_valid = SNK_parseU64(value, &options->seed);
+        } else if (strcmp(arg, "--replay") == 0) {
+            options->replay_path = value;
+            is_valid             = true;
+        }
+
+        if (!is_valid) {
+            printf("snake_bench: invalid value '%s' for '%s'\n", value, arg);
+
+            return false;
+        }
+    }
+
+    if (options->ticks == 0 && options->games == 0)
+        options->ticks = 1000000;
+
+    if (options->ticks == 0)
+        options->ticks = UINT64_MAX;
+
+    if (options->games == 0)
+        options->games = UINT64_MAX;
+
+    return true;
+}
+
+int64_t _SNK_Bench_torusDelta(const int64_t from, const int64_t to, const int64_t size) {
+    int64_t delta = to - from;
+
+    if (delta > size / 2)
+        delta -= size;
+    else if (delta < -size / 2)
+        delta += size;
+
+    return delta;
+}
+
+// Synthetic player: heads for the food along the shorter torus axis, avoids cells it can see are occupied
+// and turns randomly now and then, so games grow long bodies and still end
+SNK_GameInput _SNK_Bench_input(const SNK_Game* game, SNK_Rand* rand) {
+    const int64_t dx = _SNK_Bench_torusDelta(game->snake_head.x, game->food.x, game->grid.x);
+    const int64_t dy = _SNK_Bench_torusDelta(game->snake_head.y, game->food.y, game->grid.y);
+
+    const SNK_Direction horizontal    = dx < 0 ? SNK_Direction_Left : SNK_Direction_Right;
+    const SNK_Direction vertical      = dy < 0 ? SNK_Direction_Up : SNK_Direction_Down;
+    const bool          is_horizontal = (dx < 0 ? -dx : dx) >= (dy < 0 ? -dy : dy);
+
+    SNK_Direction candidates[4] = {
+        is_horizontal ? horizontal : vertical,
+        is_horizontal ? vertical : horizontal,
+        (SNK_Direction)SNK_Rand_range(rand, 0, 4),
+        game->direction,
+    };
+
+    if (SNK_Rand_range(rand, 0, 16) == 0)
+        candidates[0] = candidates[2];
+
+    for (size_t i = 0; i < ARRSIZE(candidates); i++) {
+        if (!SNK_Game_isOccupied(game, SNK_Direction_move(game->snake_head, candidates[i])))
+            return SNK_GameInput_fromDirection(candidates[i]);
+    }
+
+    return SNK_GameInput_fromDirection(game->direction);
+}
+
+// `count` per second of `ns`, exact while `count` times a billion fits in 64 bits
+uint64_t _SNK_Bench_perSecond(const uint64_t count, const uint64_t ns) {
+    if (SNK_mulHigh64(count, 1000000000) == 0)
+        return count * 1000000000 / ns;
+
+    return (uint64_t)((double)count * 1e9 / (double)ns);
+}
+
+int main(int argc, char** argv) {
+    _SNK_BenchOptions options;
+
+    if (!_SNK_Bench_parseArgs(argc, argv, &options)) {
+        _SNK_Bench_usage();
+
+        return EXIT_FAILURE;
+    }
+
+    SNK_Replay replay = {};
+
+    if (options.replay_path != nullptr) {
+        if (!SNK_Replay_open(&replay, options.replay_path)) {
+            printf("snake_bench: failed to open replay '%s': %s\n", options.replay_path, strerror(errno));
+
+            return EXIT_FAILURE;
+        }
+
+        options.grid       = replay.header.grid;
+        options.seed       = replay.header.seed;
+        options.delta_time = replay.header.delta_time;
+        options.ticks      = UINT64_MAX;
+        options.games      = 1;
+    }
+
+    SNK_Autopilot autopilot = {};
+
+    if (options.autopilot)
+        autopilot = SNK_Autopilot_new(options.grid);
+
+    printf("** Bench Info **\n");
+    printf("- Grid: %lld x %lld\n", options.grid.x, options.grid.y);
+    printf("- Seed: %llu\n", options.seed);
+
+    SNK_Histogram tick_ns;
+    SNK_Histogram_reset(&tick_ns);
+
+    uint64_t ticks      = 0;
+    uint64_t games      = 0;
+    uint64_t wins       = 0;
+    uint64_t score_sum  = 0;
+    uint64_t best_score = 0;
+
+    const uint64_t start = SNK_Timer_now();
+
+    while (ticks < options.ticks && games < options.games) {
+        SNK_Game game       = SNK_Game_new(options.grid, options.seed + games);
+        SNK_Rand input_rand = SNK_Rand_new(~(options.seed + games));
+
+        while (!SNK_Game_isOver(&game) && ticks < options.ticks) {
+            SNK_GameInput input = 0;
+
+            if (options.replay_path != nullptr) {
+                if (!SNK_Replay_next(&replay, &input))
+                    input = SNK_GameInput_Quit;
+            } else if (options.autopilot) {
+                input = SNK_Autopilot_input(&autopilot, &game);
+            } else {
+                input = _SNK_Bench_input(&game, &input_rand);
+            }
+
+            const uint64_t tick_start = SNK_Timer_now();
+            SNK_Game_tick(&game, input, options.delta_time);
+            const uint64_t tick_end = SNK_Timer_now();
+
+            SNK_Histogram_record(&tick_ns, tick_end - tick_start);
+            ticks++;
+        }
+
+        if (SNK_Game_isOver(&game)) {
+            games++;
+            score_sum += game.score;
+
+            if (game.score > best_score)
+                best_score = game.score;
+
+            if (game.status == SNK_GameStatus_Won)
+                wins++;
+        }
+
+        SNK_Game_free(&game);
+    }
+
+    if (options.replay_path != nullptr)
+        SNK_Replay_free(&replay);
+
+    if (options.autopilot)
+        SNK_Autopilot_free(&autopilot);
+
+    const uint64_t wall_ns     = SNK_Timer_now() - start;
+    const uint64_t tick_sum_ns = SNK_Histogram_sum(&tick_ns);
+
+    printf("** Bench Results **\n");
+    printf("- Ticks: %llu\n", ticks);
+    printf("- Games: %llu (%llu won)\n", games, wins);
+
+    if (games != 0)
+        printf("- Score: %llu avg, %llu best\n", score_sum / games, best_score);
+
+    printf("- Wall time: %llu ms\n", wall_ns / 1000000);
+
+    if (tick_sum_ns != 0)
+        printf("- Ticks/sec: %llu\n", _SNK_Bench_perSecond(ticks, tick_sum_ns));
+
+    printf("** ns/tick **\n");
+    printf("- min: %llu\n", SNK_Histogram_min(&tick_ns));
+    printf("- p50: %llu\n", SNK_Histogram_percentile(&tick_ns, 500));
+    printf("- p90: %llu\n", SNK_Histogram_percentile(&tick_ns, 900));
+    printf("- p99: %llu\n", SNK_Histogram_percentile(&tick_ns, 990));
+    printf("- p99.9: %llu\n", SNK_Histogram_percentile(&tick_ns, 999));
+    printf("- max: %llu\n", SNK_Histogram_max(&tick_ns));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,68 @@
+#include "bitmap.h"
+#include "utils.h"
+#include <stdio.h>
+
+#define _SNK_BITMAP_WORD_BITS (sizeof(uint64_t) * 8)
+
+size_t _SNK_Bitmap_wordCount(const size_t size) { return (size + _SNK_BITMAP_WORD_BITS - 1) / _SNK_BITMAP_WORD_BITS; }
+
+SNK_Bitmap SNK_Bitmap_new(const size_t size) {
+    if (size == 0) {
+        return (SNK_Bitmap){};
+    }
+
+    uint64_t* words = calloc(_SNK_Bitmap_wordCount(size), sizeof(uint64_t));
+
+    if (words == nullptr)
+        SNK_crash("Failed to allocate memory for bitmap");
+
+    return (SNK_Bitmap){
+        ._words = words,
+        ._size  = size,
+    };
+}
+
+size_t SNK_Bitmap_size(const SNK_Bitmap* bitmap) {
+    ASSERT(bitmap != nullptr);
+
+    return bitmap->_size;
+}
+
+bool SNK_Bitmap_test(const SNK_Bitmap* bitmap, const size_t index) {
+    ASSERT(bitmap != nullptr);
+    ASSERT(index < bitmap->_size);
+
+    return (bitmap->_words[index / _SNK_BITMAP_WORD_BITS] >> (index % _SNK_BITMAP_WORD_BITS)) & 1;
+}
+
+void SNK_Bitmap_set(SNK_Bitmap* bitmap, const size_t index) {
+    ASSERT(bitmap != nullptr);
+    ASSERT(index < bitmap->_size);
+
+    bitmap->_words[index / _SNK_BITMAP_WORD_BITS] |= (uint64_t)1 << (index % _SNK_BITMAP_WORD_BITS);
+}
+
+void SNK_Bitmap_clear(SNK_Bitmap* bitmap, const size_t index) {
+    ASSERT(bitmap != nullptr);
+    ASSERT(index < bitmap->_size);
+
+    bitmap->_words[index / _SNK_BITMAP_WORD_BITS] &= ~((uint64_t)1 << (index % _SNK_BITMAP_WORD_BITS));
+}
+
+void SNK_Bitmap_reset(SNK_Bitmap* bitmap) {
+    ASSERT(bitmap != nullptr);
+
+    if (bitmap->_words != nullptr)
+        memset(bitmap->_words, 0, _SNK_Bitmap_wordCount(bitmap->_size) * sizeof(uint64_t));
+}
+
+void SNK_Bitmap_free(SNK_Bitmap* bitmap) {
+    ASSERT(bitmap != nullptr);
+
+    if (bitmap->_words != nullptr) {
+        free(bitmap->_words);
+    }
+
+    bitmap->_words = nullptr;
+    bitmap->_size  = 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t* _words;
+    size_t    _size;
+} SNK_Bitmap;
+
+SNK_Bitmap SNK_Bitmap_new(size_t size);
+
+size_t SNK_Bitmap_size(const SNK_Bitmap* bitmap);
+
+bool SNK_Bitmap_test(const SNK_Bitmap* bitmap, size_t index);
+
+void SNK_Bitmap_set(SNK_Bitmap* bitmap, size_t index);
+
+void SNK_Bitmap_clear(SNK_Bitmap* bitmap, size_t index);
+
+void SNK_Bitmap_reset(SNK_Bitmap* bitmap);
+
+void SNK_Bitmap_free(SNK_Bitmap* bitmap);
@@ -0,0 +1,222 @@
+#include "blit.h"
+#include "utils.h"
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include <stdio.h>
+
+typedef uint8_t _SNK_Blit_U8x16 __attribute__((vector_size(16), aligned(1)));
+
+#if defined(__x86_64__)
+typedef long long _SNK_Blit_V128 __attribute__((vector_size(16)));
+typedef long long _SNK_Blit_V128Unaligned __attribute__((vector_size(16), aligned(1)));
+typedef uint32_t  _SNK_Blit_U32x4 __attribute__((vector_size(16), aligned(4)));
+typedef uint32_t  _SNK_Blit_U32x8 __attribute__((vector_size(32), aligned(4)));
+#endif
+
+// Bytes moved per iteration of the wide loop
+constexpr size_t _SNK_BLIT_CHUNK = 64;
+
+void SNK_Blit_copy(void* dst, const void* src, const size_t size) {
+    ASSERT(dst != nullptr || size == 0);
+    ASSERT(src != nullptr || size == 0);
+
+    auto       out = (uint8_t*)dst;
+    const auto in  = (const uint8_t*)src;
+
+    size_t offset = 0;
+
+    for (; offset + _SNK_BLIT_CHUNK <= size; offset += _SNK_BLIT_CHUNK) {
+        for (size_t i = 0; i < _SNK_BLIT_CHUNK; i += 16)
+            *(_SNK_Blit_U8x16*)(out + offset + i) = *(const _SNK_Blit_U8x16*)(in + offset + i);
+    }
+
+    for (; offset + 16 <= size; offset += 16)
+        *(_SNK_Blit_U8x16*)(out + offset) = *(const _SNK_Blit_U8x16*)(in + offset);
+
+    for (; offset < size; offset++)
+        out[offset] = in[offset];
+}
+
+void SNK_Blit_stream(void* dst, const void* src, size_t size) {
+    ASSERT(dst != nullptr || size == 0);
+    ASSERT(src != nullptr || size == 0);
+
+    auto       out = (uint8_t*)dst;
+    const auto in  = (const uint8_t*)src;
+
+#if defined(__x86_64__)
+    // movntdq needs a 16 byte aligned destination
+    const size_t head = (16 - ((uintptr_t)out & 15)) & 15;
+
+    if (head >= size) {
+        memcpy(out, in, size);
+
+        return;
+    }
+
+    memcpy(out, in, head);
+
+    size_t offset = head;
+
+    for (; offset + _SNK_BLIT_CHUNK <= size; offset += _SNK_BLIT_CHUNK) {
+        for (size_t i = 0; i < _SNK_BLIT_CHUNK; i += 16) {
+            const _SNK_Blit_V128 value = *(const _SNK_Blit_V128Unaligned*)(in + offset + i);
+
+            __builtin_ia32_movntdq((_SNK_Blit_V128*)(out + offset + i), value);
+        }
+    }
+
+    memcpy(out + offset, in + offset, size - offset);
+#elif defined(__aarch64__)
+    size_t offset = 0;
+
+    for (; offset + _SNK_BLIT_CHUNK <= size; offset += _SNK_BLIT_CHUNK) {
+        __asm__ volatile("ldp q0, q1, [%1]\n"
+                         "ldp q2, q3, [%1, #32]\n"
+                         "stnp q0, q1, [%0]\n"
+                         "stnp q2, q3, [%0, #32]\n"
+                         :
+                         : "r"(out + offset), "r"(in + offset)
+                         : "v0", "v1", "v2", "v3", "memory");
+    }
+
+    memcpy(out + offset, in + offset, size - offset);
+#else
+    memcpy(out, in, size);
+#endif
+}
+
+void SNK_Blit_fence() {
+#if defined(__x86_64__)
+    __builtin_ia32_sfence();
+#elif defined(__aarch64__)
+    __asm__ volatile("dmb oshst" ::: "memory");
+#else
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+#endif
+}
+
+void _SNK_Blit_fill32Scalar(uint32_t* dst, const uint32_t value, const size_t count) {
+    for (size_t i = 0; i < count; i++)
+        dst[i] = value;
+}
+
+#if defined(__x86_64__)
+void _SNK_Blit_fill32SSE2(uint32_t* dst, const uint32_t value, const size_t count) {
+    const _SNK_Blit_U32x4 v = {value, value, value, value};
+
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        *(_SNK_Blit_U32x4*)(dst + i)      = v;
+        *(_SNK_Blit_U32x4*)(dst + i + 4)  = v;
+        *(_SNK_Blit_U32x4*)(dst + i + 8)  = v;
+        *(_SNK_Blit_U32x4*)(dst + i + 12) = v;
+    }
+
+    for (; i + 4 <= count; i += 4)
+        *(_SNK_Blit_U32x4*)(dst + i) = v;
+
+    _SNK_Blit_fill32Scalar(dst + i, value, count - i);
+}
+
+__attribute__((target("avx2"))) void _SNK_Blit_fill32AVX2(uint32_t* dst, const uint32_t value, const size_t count) {
+    const _SNK_Blit_U32x8 v = {value, value, value, value, value, value, value, value};
+
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        *(_SNK_Blit_U32x8*)(dst + i)      = v;
+        *(_SNK_Blit_U32x8*)(dst + i + 8)  = v;
+        *(_SNK_Blit_U32x8*)(dst + i + 16) = v;
+        *(_SNK_Blit_U32x8*)(dst + i + 24) = v;
+    }
+
+    for (; i + 8 <= count; i += 8)
+        *(_SNK_Blit_U32x8*)(dst + i) = v;
+
+    _SNK_Blit_fill32Scalar(dst + i, value, count - i);
+}
+
+bool _SNK_Blit_hasAVX2() {
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || (ecx & bit_OSXSAVE) == 0 || (ecx & bit_AVX) == 0)
+        return false;
+
+    // The kernel also has to save the YMM registers on context switches
+    unsigned int xcr0_low, xcr0_high;
+    __asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+
+    if ((xcr0_low & 0x6) != 0x6)
+        return false;
+
+    return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_AVX2) != 0;
+}
+#elif defined(__aarch64__)
+void _SNK_Blit_fill32NEON(uint32_t* dst, const uint32_t value, const size_t count) {
+    const uint32x4_t v = vdupq_n_u32(value);
+
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        vst1q_u32(dst + i, v);
+        vst1q_u32(dst + i + 4, v);
+        vst1q_u32(dst + i + 8, v);
+        vst1q_u32(dst + i + 12, v);
+    }
+
+    for (; i + 4 <= count; i += 4)
+        vst1q_u32(dst + i, v);
+
+    _SNK_Blit_fill32Scalar(dst + i, value, count - i);
+}
+#endif
+
+typedef void (*_SNK_Blit_Fill32)(uint32_t* dst, uint32_t value, size_t count);
+
+// Picked on first use, the best kernel depends on the CPU at runtime on x86
+_SNK_Blit_Fill32 _SNK_Blit_fill32Kernel = nullptr;
+
+_SNK_Blit_Fill32 _SNK_Blit_selectFill32() {
+#if defined(__x86_64__)
+    return _SNK_Blit_hasAVX2() ? _SNK_Blit_fill32AVX2 : _SNK_Blit_fill32SSE2;
+#elif defined(__aarch64__)
+    return _SNK_Blit_fill32NEON;
+#else
+    return _SNK_Blit_fill32Scalar;
+#endif
+}
+
+void SNK_Blit_fill32(uint32_t* dst, const uint32_t value, const size_t count) {
+    ASSERT(dst != nullptr || count == 0);
+
+    if (_SNK_Blit_fill32Kernel == nullptr)
+        _SNK_Blit_fill32Kernel = _SNK_Blit_selectFill32();
+
+    _SNK_Blit_fill32Kernel(dst, value, count);
+}
+
+void SNK_Blit_fill16(uint16_t* dst, const uint16_t value, size_t count) {
+    ASSERT(dst != nullptr || count == 0);
+    ASSERT(((uintptr_t)dst & 1) == 0);
+
+    if (count == 0)
+        return;
+
+    // Pairs of pixels go through the 32-bit kernels, which need 4 byte alignment
+    if (((uintptr_t)dst & 3) != 0) {
+        *dst++ = value;
+        count--;
+    }
+
+    SNK_Blit_fill32((uint32_t*)dst, ((uint32_t)value << 16) | value, count / 2);
+
+    if ((count & 1) != 0)
+        dst[count - 1] = value;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+// Copies `size` bytes between cached buffers with wide loads and stores, nolibc's memcpy goes byte by byte
+void SNK_Blit_copy(void* dst, const void* src, size_t size);
+
+// Copies `size` bytes into memory that is written once and not read back, such as a mapped scanout buffer.
+// Uses non-temporal stores where the CPU has them, so the copy doesn't evict the cache for write-combined memory.
+void SNK_Blit_stream(void* dst, const void* src, size_t size);
+
+// Orders the stores of the preceding SNK_Blit_stream calls before anything that follows, e.g. a page flip
+void SNK_Blit_fence();
+
+// Sets `count` pixels starting at `dst` to `value`, with the widest stores the CPU has
+void SNK_Blit_fill32(uint32_t* dst, uint32_t value, size_t count);
+
+// Same as SNK_Blit_fill32 for 16-bit pixels
+void SNK_Blit_fill16(uint16_t* dst, uint16_t value, size_t count);
@@ -0,0 +1,94 @@
+#include "cellset.h"
+#include "utils.h"
+#include <stdio.h>
+
+SNK_CellSet SNK_CellSet_new(const size_t capacity, const bool fill) {
+    ASSERT(capacity != 0);
+    ASSERT(capacity <= UINT32_MAX);
+
+    uint32_t* dense  = malloc(capacity * sizeof(uint32_t));
+    uint32_t* sparse = malloc(capacity * sizeof(uint32_t));
+
+    if (dense == nullptr || sparse == nullptr)
+        SNK_crash("Failed to allocate memory for cell set");
+
+    SNK_CellSet set = {
+        ._dense    = dense,
+        ._sparse   = sparse,
+        ._size     = 0,
+        ._capacity = capacity,
+    };
+
+    if (fill) {
+        for (size_t i = 0; i < capacity; i++) {
+            dense[i]  = (uint32_t)i;
+            sparse[i] = (uint32_t)i;
+        }
+
+        set._size = capacity;
+    }
+
+    return set;
+}
+
+size_t SNK_CellSet_size(const SNK_CellSet* set) {
+    ASSERT(set != nullptr);
+
+    return set->_size;
+}
+
+bool SNK_CellSet_contains(const SNK_CellSet* set, const size_t cell) {
+    ASSERT(set != nullptr);
+    ASSERT(cell < set->_capacity);
+
+    const uint32_t index = set->_sparse[cell];
+
+    return index < set->_size && set->_dense[index] == cell;
+}
+
+void SNK_CellSet_insert(SNK_CellSet* set, const size_t cell) {
+    ASSERT(set != nullptr);
+
+    if (SNK_CellSet_contains(set, cell))
+        return;
+
+    set->_dense[set->_size] = (uint32_t)cell;
+    set->_sparse[cell]      = (uint32_t)set->_size;
+    set->_size++;
+}
+
+void SNK_CellSet_remove(SNK_CellSet* set, const size_t cell) {
+    ASSERT(set != nullptr);
+
+    if (!SNK_CellSet_contains(set, cell))
+        return;
+
+    // Move the last member into the hole so the members stay packed
+    const uint32_t index = set->_sparse[cell];
+    const uint32_t last  = set->_dense[set->_size - 1];
+
+    set->_dense[index] = last;
+    set->_sparse[last] = index;
+    set->_size--;
+}
+
+size_t SNK_CellSet_at(const SNK_CellSet* set, const size_t index) {
+    ASSERT(set != nullptr);
+    ASSERT(index < set->_size);
+
+    return set->_dense[index];
+}
+
+void SNK_CellSet_free(SNK_CellSet* set) {
+    ASSERT(set != nullptr);
+
+    if (set->_dense != nullptr) {
+        free(set->_dense);
+    }
+
+    if (set->_sparse != nullptr) {
+        free(set->_sparse);
+    }
+
+    *set = (SNK_CellSet){};
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+// Dense set of cell indices in [0, capacity) with constant time insert, remove and indexed access
+typedef struct {
+    // Members packed at the front
+    uint32_t* _dense;
+    // Position of each cell in _dense, only meaningful for members
+    uint32_t* _sparse;
+    size_t    _size;
+    size_t    _capacity;
+} SNK_CellSet;
+
+SNK_CellSet SNK_CellSet_new(size_t capacity, bool fill);
+
+size_t SNK_CellSet_size(const SNK_CellSet* set);
+
+bool SNK_CellSet_contains(const SNK_CellSet* set, size_t cell);
+
+void SNK_CellSet_insert(SNK_CellSet* set, size_t cell);
+
+void SNK_CellSet_remove(SNK_CellSet* set, size_t cell);
+
+size_t SNK_CellSet_at(const SNK_CellSet* set, size_t index);
+
+void SNK_CellSet_free(SNK_CellSet* set);
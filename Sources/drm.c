@@ -3,6 +3,7 @@
 #include "utils.h"
 #include "vec.h"
 #include <drm/drm.h>
+#include <drm/drm_fourcc.h>
 #include <drm/drm_mode.h>
 #include <stdio.h>
 
@@ -20,6 +21,8 @@ typedef struct {
     __u32 connector_id;
     __u32 crtc_id;
     __u32 encoder_id;
+    // Position of the CRTC in the card's list, which is its bit in possible_crtcs masks
+    size_t crtc_index;
 } _SNK_DRM_Resources;
 
 void _SNK_DRM_Resources_dump(const _SNK_DRM_Resources* resources) {
@@ -29,6 +32,7 @@ void _SNK_DRM_Resources_dump(const _SNK_DRM_Resources* resources) {
     printf("- Connector ID: %d\n", resources->connector_id);
     printf("- CRTC ID: %d\n", resources->crtc_id);
     printf("- Encoder ID: %d\n", resources->encoder_id);
+    printf("- CRTC index: %lu\n", resources->crtc_index);
 }
 
 typedef struct {
@@ -80,6 +84,46 @@ void _SNK_DRM_Connector_free(_SNK_DRM_Connector* connector) {
     SNK_Vec_free(&connector->prop_values);
 }
 
+// Reads the connector with its modes, encoders and props, and its connection status and current encoder
+bool _SNK_DRM_Connector_get(const SNK_DRM* drm, const __u32 id, _SNK_DRM_Connector* connector,
+                            struct drm_mode_get_connector* info) {
+    ASSERT(connector != nullptr);
+    ASSERT(info != nullptr);
+
+    struct drm_mode_modeinfo      temp          = {};
+    struct drm_mode_get_connector get_connector = {
+        .count_modes  = 1,
+        .connector_id = id,
+        .modes_ptr    = (__u64)&temp,
+    };
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETCONNECTOR, &get_connector) == -1) {
+        printf("Failed to get connector meta data: %s\n", strerror(errno));
+
+        return false;
+    }
+
+    *connector = _SNK_DRM_Connector_new(id, get_connector.count_modes, get_connector.count_encoders,
+                                        get_connector.count_props);
+
+    get_connector.modes_ptr       = (__u64)SNK_Vec_data(&connector->modes);
+    get_connector.encoders_ptr    = (__u64)SNK_Vec_data(&connector->encoders);
+    get_connector.props_ptr       = (__u64)SNK_Vec_data(&connector->props);
+    get_connector.prop_values_ptr = (__u64)SNK_Vec_data(&connector->prop_values);
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETCONNECTOR, &get_connector) == -1) {
+        printf("Failed to get connector meta data: %s\n", strerror(errno));
+
+        _SNK_DRM_Connector_free(connector);
+
+        return false;
+    }
+
+    *info = get_connector;
+
+    return true;
+}
+
 typedef struct {
     __u32 handle;
     __u32 pitch;
@@ -96,337 +140,1626 @@ void _SNK_DRM_DumbBuffer_dump(const _SNK_DRM_DumbBuffer* buffer) {
 }
 
 typedef struct {
-    _SNK_DRM_Resources        resources;
-    _SNK_DRM_Connector        connector;
-    struct drm_mode_modeinfo* preferred_mode;
-    _SNK_DRM_DumbBuffer       dumb_buffer;
-    __u32                     fb_id;
-    void*                     data;
-    struct drm_mode_crtc      old_crtc;
-} _SNK_DRM_Data;
+    _SNK_DRM_DumbBuffer dumb_buffer;
+    __u32               fb_id;
+    void*               data;
+} _SNK_DRM_Buffer;
 
-bool SNK_DRM_open(const char* device, SNK_DRM* drm) {
-    ASSERT(drm != nullptr);
-    ASSERT(device != nullptr);
+typedef struct {
+    // __u32
+    SNK_Vec props;
+    // __u64
+    SNK_Vec prop_values;
+} _SNK_DRM_ObjectProps;
 
-    const int fd = open(device, O_RDWR);
+void _SNK_DRM_ObjectProps_free(_SNK_DRM_ObjectProps* props) {
+    ASSERT(props != nullptr);
+
+    SNK_Vec_free(&props->props);
+    SNK_Vec_free(&props->prop_values);
+}
+
+bool _SNK_DRM_ObjectProps_get(const SNK_DRM* drm, const __u32 obj_id, const __u32 obj_type,
+                              _SNK_DRM_ObjectProps* props) {
+    ASSERT(props != nullptr);
+
+    struct drm_mode_obj_get_properties get_props = {
+        .obj_id   = obj_id,
+        .obj_type = obj_type,
+    };
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_OBJ_GETPROPERTIES, &get_props) == -1) {
+        printf("Failed to get properties of object %d: %s\n", obj_id, strerror(errno));
 
-    if (fd < 0)
         return false;
+    }
 
-    drm->_fd = fd;
+    *props = (_SNK_DRM_ObjectProps){
+        .props       = SNK_Vec_new(get_props.count_props, sizeof(__u32), true),
+        .prop_values = SNK_Vec_new(get_props.count_props, sizeof(__u64), true),
+    };
+
+    get_props.props_ptr       = (__u64)SNK_Vec_data(&props->props);
+    get_props.prop_values_ptr = (__u64)SNK_Vec_data(&props->prop_values);
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_OBJ_GETPROPERTIES, &get_props) == -1) {
+        printf("Failed to get properties of object %d: %s\n", obj_id, strerror(errno));
+
+        _SNK_DRM_ObjectProps_free(props);
+
+        return false;
+    }
 
     return true;
 }
 
-bool SNK_DRM_initFB(SNK_DRM* drm) {
-    _SNK_DRM_ASSERT(drm);
+// Returns the ID of the property called `name` and stores its value, or 0 if the object doesn't have it
+__u32 _SNK_DRM_ObjectProps_find(const SNK_DRM* drm, const _SNK_DRM_ObjectProps* props, const char* name,
+                                __u64* value) {
+    ASSERT(props != nullptr);
+    ASSERT(name != nullptr);
 
-    do {
-        struct drm_get_cap cap = {
-            .capability = DRM_CAP_DUMB_BUFFER,
+    for (size_t i = 0; i < SNK_Vec_size(&props->props); i++) {
+        struct drm_mode_get_property get_prop = {
+            .prop_id = *(__u32*)SNK_Vec_at(&props->props, i),
         };
 
-        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_GET_CAP, &cap) == -1) {
-            printf("Failed to get DRM capability: %s\n", strerror(errno));
-
-            return false;
-        }
+        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETPROPERTY, &get_prop) == -1)
+            continue;
 
-        if (cap.value == 0) {
-            printf("dumb buffer capability not supported\n");
+        if (strncmp(get_prop.name, name, DRM_PROP_NAME_LEN) == 0) {
+            if (value != nullptr)
+                *value = *(__u64*)SNK_Vec_at(&props->prop_values, i);
 
-            return false;
+            return get_prop.prop_id;
         }
-    } while (false);
-
-    drm->_data = malloc(sizeof(_SNK_DRM_Data));
+    }
 
-    if (drm->_data == nullptr)
-        SNK_crash("Failed to allocate DRM data");
+    return 0;
+}
 
-    const auto data = (_SNK_DRM_Data*)drm->_data;
+// Values of a plane's "type" property, from the kernel's enum drm_plane_type
+constexpr __u64 _SNK_DRM_PLANE_TYPE_OVERLAY = 0;
+constexpr __u64 _SNK_DRM_PLANE_TYPE_PRIMARY = 1;
+constexpr __u64 _SNK_DRM_PLANE_TYPE_CURSOR  = 2;
+
+// Cursor planes scan out buffers of this size unless the driver reports another
+constexpr __u64 _SNK_DRM_DEFAULT_CURSOR_SIZE = 64;
+
+typedef enum {
+    _SNK_DRM_PlaneProp_FbId,
+    _SNK_DRM_PlaneProp_CrtcId,
+    _SNK_DRM_PlaneProp_SrcX,
+    _SNK_DRM_PlaneProp_SrcY,
+    _SNK_DRM_PlaneProp_SrcW,
+    _SNK_DRM_PlaneProp_SrcH,
+    _SNK_DRM_PlaneProp_CrtcX,
+    _SNK_DRM_PlaneProp_CrtcY,
+    _SNK_DRM_PlaneProp_CrtcW,
+    _SNK_DRM_PlaneProp_CrtcH,
+    // Optional, without it damage goes through DIRTYFB
+    _SNK_DRM_PlaneProp_DamageClips,
+    _SNK_DRM_PlaneProp_Count,
+} _SNK_DRM_PlaneProp;
+
+const char* _SNK_DRM_PLANE_PROP_NAMES[_SNK_DRM_PlaneProp_Count] = {
+    "FB_ID",  "CRTC_ID", "SRC_X",  "SRC_Y",  "SRC_W",           "SRC_H",
+    "CRTC_X", "CRTC_Y",  "CRTC_W", "CRTC_H", "FB_DAMAGE_CLIPS",
+};
 
-    do {
-        struct drm_mode_card_res card_res = {};
+typedef struct {
+    __u32 plane_props[_SNK_DRM_PlaneProp_Count];
+    __u32 crtc_mode_id;
+    __u32 crtc_active;
+    __u32 connector_crtc_id;
+    // Blob holding the mode of the last modeset, 0 before the first one
+    __u32 mode_blob_id;
+} _SNK_DRM_Atomic;
+
+// Enough for a modeset that also places every sprite
+constexpr size_t _SNK_DRM_ATOMIC_MAX_PROPS = 48;
+
+// Property updates for one commit, the ones for the same object have to be added one after another
+typedef struct {
+    __u32  objs[_SNK_DRM_ATOMIC_MAX_PROPS];
+    __u32  count_props[_SNK_DRM_ATOMIC_MAX_PROPS];
+    __u32  props[_SNK_DRM_ATOMIC_MAX_PROPS];
+    __u64  prop_values[_SNK_DRM_ATOMIC_MAX_PROPS];
+    size_t obj_count;
+    size_t prop_count;
+} _SNK_DRM_AtomicRequest;
+
+void _SNK_DRM_AtomicRequest_add(_SNK_DRM_AtomicRequest* request, const __u32 obj_id, const __u32 prop_id,
+                                const __u64 value) {
+    ASSERT(request != nullptr);
+    ASSERT(request->prop_count < _SNK_DRM_ATOMIC_MAX_PROPS);
+    ASSERT(prop_id != 0);
+
+    if (request->obj_count == 0 || request->objs[request->obj_count - 1] != obj_id) {
+        request->objs[request->obj_count]        = obj_id;
+        request->count_props[request->obj_count] = 0;
+        request->obj_count++;
+    }
 
-        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETRESOURCES, &card_res) == -1) {
-            printf("Failed to get DRM resources: %s\n", strerror(errno));
+    request->count_props[request->obj_count - 1]++;
+    request->props[request->prop_count]       = prop_id;
+    request->prop_values[request->prop_count] = value;
+    request->prop_count++;
+}
 
-            return false;
-        }
+long _SNK_DRM_AtomicRequest_commit(const SNK_DRM* drm, const _SNK_DRM_AtomicRequest* request, const __u32 flags,
+                                   const __u64 user_data) {
+    ASSERT(request != nullptr);
+
+    struct drm_mode_atomic atomic = {
+        .flags           = flags,
+        .count_objs      = request->obj_count,
+        .objs_ptr        = (__u64)request->objs,
+        .count_props_ptr = (__u64)request->count_props,
+        .props_ptr       = (__u64)request->props,
+        .prop_values_ptr = (__u64)request->prop_values,
+        .user_data       = user_data,
+    };
 
-        if (card_res.count_connectors != 1) {
-            printf("Expected 1 connector, got %d\n", card_res.count_connectors);
+    return _SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_ATOMIC, &atomic);
+}
 
-            return false;
-        }
+// Overlay or cursor plane of the CRTC that a sprite can be shown on
+typedef struct {
+    __u32 id;
+    bool  is_cursor;
+    // __u32 fourcc codes the plane can scan out
+    SNK_Vec formats;
+} _SNK_DRM_SpritePlane;
 
-        if (card_res.count_crtcs != 1) {
-            printf("Expected 1 CRTC, got %d\n", card_res.count_crtcs);
+typedef struct {
+    __u32           plane_id;
+    __u32           plane_props[_SNK_DRM_PlaneProp_Count];
+    _SNK_DRM_Buffer buffer;
+    SNK_DRM_Format  format;
+    // Size of the image, cursor planes pad it out to the cursor size with transparent pixels
+    size_t  width;
+    size_t  height;
+    size_t  buffer_width;
+    size_t  buffer_height;
+    int32_t x;
+    int32_t y;
+    bool    is_visible;
+    // Moved since it was last committed
+    bool is_dirty;
+} _SNK_DRM_Sprite;
 
-            return false;
-        }
+typedef struct {
+    _SNK_DRM_Resources resources;
+    _SNK_DRM_Connector connector;
+    // Mode picked by the mode policy, one of the connector's
+    const struct drm_mode_modeinfo* mode;
+    _SNK_DRM_Buffer                 buffers[SNK_DRM_MAX_BUFFERS];
+    size_t                          buffer_count;
+    // Size of the buffers, the mode's divided by `scale`
+    size_t width;
+    size_t height;
+    // The primary plane scales the buffers up by this much, 1 if they are the mode's size
+    size_t scale;
+    // Cached copy of the frame in system RAM, the mapped buffers are often write-combined or uncached
+    void*          shadow;
+    SNK_DRM_Format format;
+    // 0 if the driver can't list planes
+    __u32 primary_plane_id;
+    // __u32 fourcc codes the primary plane can scan out
+    SNK_Vec plane_formats;
+    // Buffer the next frame is drawn into
+    size_t back;
+    // Buffer being scanned out, SIZE_MAX until the first frame is presented
+    size_t front;
+    // Buffer queued by a page flip that hasn't completed yet, SIZE_MAX if none
+    size_t pending;
+    // Mode last set on the CRTC, nullptr until the first frame is presented
+    const struct drm_mode_modeinfo* active_mode;
+    // Cleared once the driver turns out not to implement DIRTYFB
+    bool has_dirty_fb;
+    // Present with atomic commits, cleared if the driver rejects them
+    bool            is_atomic;
+    _SNK_DRM_Atomic atomic;
+    // Flip without waiting for vblank, cleared if the driver rejects it
+    bool                 async_flip;
+    struct drm_mode_crtc old_crtc;
+    // _SNK_DRM_SpritePlane, every plane besides the primary one that can show on the CRTC
+    SNK_Vec         sprite_planes;
+    _SNK_DRM_Sprite sprites[SNK_DRM_MAX_SPRITES];
+    size_t          sprite_count;
+} _SNK_DRM_Data;
 
-        if (card_res.count_encoders != 1) {
-            printf("Expected 1 encoder, got %d\n", card_res.count_encoders);
+__u32 _SNK_DRM_Format_fourcc(const SNK_DRM_Format format) {
+    switch (format) {
+    case SNK_DRM_Format_XRGB8888:
+        return DRM_FORMAT_XRGB8888;
+    case SNK_DRM_Format_RGB565:
+        return DRM_FORMAT_RGB565;
+    case SNK_DRM_Format_ARGB8888:
+        return DRM_FORMAT_ARGB8888;
+    }
 
-            return false;
-        }
+    SNK_crash("Unknown pixel format %d", format);
+}
 
-        card_res.connector_id_ptr = (__u64)&data->resources.connector_id;
-        card_res.crtc_id_ptr      = (__u64)&data->resources.crtc_id;
-        card_res.encoder_id_ptr   = (__u64)&data->resources.encoder_id;
+const char* _SNK_DRM_Format_name(const SNK_DRM_Format format) {
+    switch (format) {
+    case SNK_DRM_Format_XRGB8888:
+        return "XRGB8888";
+    case SNK_DRM_Format_RGB565:
+        return "RGB565";
+    case SNK_DRM_Format_ARGB8888:
+        return "ARGB8888";
+    }
 
-        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETRESOURCES, &card_res) == -1) {
-            printf("Failed to get DRM resources\n");
+    SNK_crash("Unknown pixel format %d", format);
+}
 
-            return false;
-        }
+size_t SNK_DRM_Format_bytesPerPixel(const SNK_DRM_Format format) {
+    switch (format) {
+    case SNK_DRM_Format_XRGB8888:
+    case SNK_DRM_Format_ARGB8888:
+        return 4;
+    case SNK_DRM_Format_RGB565:
+        return 2;
+    }
 
-        if (data->resources.connector_id == 0) {
-            printf("Failed to get connector ID\n");
+    SNK_crash("Unknown pixel format %d", format);
+}
 
-            return false;
-        }
+bool _SNK_DRM_Buffer_create(const SNK_DRM* drm, const size_t width, const size_t height, const SNK_DRM_Format format,
+                            _SNK_DRM_Buffer* buffer) {
+    do {
+        struct drm_mode_create_dumb create_dumb = {
+            .width  = width,
+            .height = height,
+            .bpp    = SNK_DRM_Format_bytesPerPixel(format) * 8,
+        };
 
-        if (data->resources.crtc_id == 0) {
-            printf("Failed to get CRTC ID\n");
+        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_CREATE_DUMB, &create_dumb) == -1) {
+            printf("Failed to create dumb buffer: %s\n", strerror(errno));
 
             return false;
         }
 
-        if (data->resources.encoder_id == 0) {
-            printf("Failed to get encoder ID\n");
-
-            return false;
-        }
+        buffer->dumb_buffer.handle = create_dumb.handle;
+        buffer->dumb_buffer.pitch  = create_dumb.pitch;
+        buffer->dumb_buffer.size   = create_dumb.size;
     } while (false);
 
-    _SNK_DRM_Resources_dump(&data->resources);
+    printf("Using dumb buffer info:\n");
+    _SNK_DRM_DumbBuffer_dump(&buffer->dumb_buffer);
 
     do {
-        struct drm_mode_crtc current_crtc = {
-            .crtc_id = data->resources.crtc_id,
+        struct drm_mode_fb_cmd2 fb_cmd = {
+            .width        = width,
+            .height       = height,
+            .pixel_format = _SNK_DRM_Format_fourcc(format),
+            .handles      = {buffer->dumb_buffer.handle},
+            .pitches      = {buffer->dumb_buffer.pitch},
         };
 
-        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETCRTC, &current_crtc) == -1) {
-            printf("Failed to get current CRTC: %s\n", strerror(errno));
+        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_ADDFB2, &fb_cmd) == -1) {
+            printf("Failed to add framebuffer: %s\n", strerror(errno));
 
             return false;
         }
 
-        data->old_crtc = current_crtc;
+        buffer->fb_id = fb_cmd.fb_id;
     } while (false);
 
+    printf("Using framebuffer ID: %d\n", buffer->fb_id);
+
     do {
-        struct drm_mode_modeinfo      temp          = {};
-        struct drm_mode_get_connector get_connector = {
-            .count_modes  = 1,
-            .connector_id = data->resources.connector_id,
-            .modes_ptr    = (__u64)&temp,
+        struct drm_mode_map_dumb map_dumb = {
+            .handle = buffer->dumb_buffer.handle,
         };
 
-        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETCONNECTOR, &get_connector) == -1) {
-            printf("Failed to get connector meta data: %s\n", strerror(errno));
+        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_MAP_DUMB, &map_dumb) == -1) {
+            printf("Failed to map dumb buffer: %s\n", strerror(errno));
 
             return false;
         }
 
-        data->connector = _SNK_DRM_Connector_new(data->resources.connector_id, get_connector.count_modes,
-                                                 get_connector.count_encoders, get_connector.count_props);
+        printf("Framebuffer offset: %llu\n", map_dumb.offset);
+
+        buffer->data = mmap(nullptr, buffer->dumb_buffer.size, PROT_READ | PROT_WRITE, MAP_SHARED, drm->_fd,
+                            (off_t)map_dumb.offset);
 
-        get_connector.modes_ptr       = (__u64)SNK_Vec_data(&data->connector.modes);
-        get_connector.encoders_ptr    = (__u64)SNK_Vec_data(&data->connector.encoders);
-        get_connector.props_ptr       = (__u64)SNK_Vec_data(&data->connector.props);
-        get_connector.prop_values_ptr = (__u64)SNK_Vec_data(&data->connector.prop_values);
+        if (buffer->data == MAP_FAILED) {
+            buffer->data = nullptr;
 
-        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETCONNECTOR, &get_connector) == -1) {
-            printf("Failed to get connector meta data: %s\n", strerror(errno));
+            printf("Failed to mmap dumb buffer: %s\n", strerror(errno));
 
             return false;
         }
 
-        if (get_connector.connection != connector_status_connected) {
-            printf("Connector %d is not connected\n", data->resources.connector_id);
+        printf("Framebuffer data: %p\n", buffer->data);
+    } while (false);
+
+    memset(buffer->data, 0, buffer->dumb_buffer.size);
+
+    return true;
+}
+
+void _SNK_DRM_Buffer_destroy(const SNK_DRM* drm, _SNK_DRM_Buffer* buffer) {
+    if (buffer->data != nullptr)
+        munmap(buffer->data, buffer->dumb_buffer.size);
+
+    if (buffer->fb_id != 0) {
+        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_RMFB, &buffer->fb_id) == -1)
+            printf("Failed to remove framebuffer: %s\n", strerror(errno));
+    }
+
+    if (buffer->dumb_buffer.handle != 0) {
+        struct drm_mode_destroy_dumb destroy_dumb = {
+            .handle = buffer->dumb_buffer.handle,
+        };
+
+        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy_dumb) == -1)
+            printf("Failed to destroy dumb buffer: %s\n", strerror(errno));
+    }
+
+    *buffer = (_SNK_DRM_Buffer){};
+}
+
+// Creates `count` buffers of the mode's size divided by the scale
+bool _SNK_DRM_createBuffers(const SNK_DRM* drm, _SNK_DRM_Data* data, const size_t count) {
+    data->width  = data->mode->hdisplay / data->scale;
+    data->height = data->mode->vdisplay / data->scale;
 
+    for (size_t i = 0; i < count; i++) {
+        if (!_SNK_DRM_Buffer_create(drm, data->width, data->height, data->format, &data->buffers[i]))
             return false;
-        }
 
-        for (size_t i = 0; i < SNK_Vec_size(&data->connector.modes); i++) {
-            const auto mode = (struct drm_mode_modeinfo*)SNK_Vec_at(&data->connector.modes, i);
+        data->buffer_count++;
+    }
 
-            ASSERT(mode != nullptr);
+    return true;
+}
 
-            if (mode->type & DRM_MODE_TYPE_PREFERRED) {
-                data->preferred_mode = mode;
+void _SNK_DRM_destroyBuffers(const SNK_DRM* drm, _SNK_DRM_Data* data) {
+    for (size_t i = 0; i < data->buffer_count; i++)
+        _SNK_DRM_Buffer_destroy(drm, &data->buffers[i]);
 
-                break;
-            }
-        }
-    } while (false);
+    data->buffer_count = 0;
+}
 
-    printf("Using connector info:\n");
-    _SNK_DRM_Connnector_dump(&data->connector);
+bool _SNK_DRM_setClientCap(const SNK_DRM* drm, const __u64 capability) {
+    struct drm_set_client_cap cap = {
+        .capability = capability,
+        .value      = 1,
+    };
 
-    printf("Preferred mode: %s\n", data->preferred_mode->name);
+    return _SNK_DRM_ioctl(drm, DRM_IOCTL_SET_CLIENT_CAP, &cap) != -1;
+}
 
-    do {
-        struct drm_mode_create_dumb create_dumb = {
-            .width  = data->preferred_mode->hdisplay,
-            .height = data->preferred_mode->vdisplay,
-            .bpp    = 32,
-        };
+bool _SNK_DRM_hasCap(const SNK_DRM* drm, const __u64 capability) {
+    struct drm_get_cap cap = {
+        .capability = capability,
+    };
 
-        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_CREATE_DUMB, &create_dumb) == -1) {
-            printf("Failed to create dumb buffer: %s\n", strerror(errno));
+    return _SNK_DRM_ioctl(drm, DRM_IOCTL_GET_CAP, &cap) != -1 && cap.value != 0;
+}
 
-            return false;
-        }
+// Returns the capability's value, or `fallback` if the driver doesn't report it
+__u64 _SNK_DRM_getCap(const SNK_DRM* drm, const __u64 capability, const __u64 fallback) {
+    struct drm_get_cap cap = {
+        .capability = capability,
+    };
 
-        data->dumb_buffer.handle = create_dumb.handle;
-        data->dumb_buffer.pitch  = create_dumb.pitch;
-        data->dumb_buffer.size   = create_dumb.size;
-    } while (false);
+    return _SNK_DRM_ioctl(drm, DRM_IOCTL_GET_CAP, &cap) != -1 && cap.value != 0 ? cap.value : fallback;
+}
 
-    printf("Using dumb buffer info:\n");
-    _SNK_DRM_DumbBuffer_dump(&data->dumb_buffer);
+// Reads the formats the plane can scan out into `formats`
+bool _SNK_DRM_getPlaneFormats(const SNK_DRM* drm, struct drm_mode_get_plane* get_plane, SNK_Vec* formats) {
+    *formats = SNK_Vec_new(get_plane->count_format_types, sizeof(__u32), true);
 
-    do {
-        struct drm_mode_fb_cmd fb_cmd = {
-            .width  = data->preferred_mode->hdisplay,
-            .height = data->preferred_mode->vdisplay,
-            .pitch  = data->dumb_buffer.pitch,
-            .bpp    = 32,
-            .depth  = 24,
-            .handle = data->dumb_buffer.handle,
-        };
+    get_plane->format_type_ptr = (__u64)SNK_Vec_data(formats);
 
-        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_ADDFB, &fb_cmd) == -1) {
-            printf("Failed to add framebuffer: %s\n", strerror(errno));
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETPLANE, get_plane) == -1) {
+        printf("Failed to get formats of plane %d: %s\n", get_plane->plane_id, strerror(errno));
 
-            return false;
-        }
+        SNK_Vec_free(formats);
 
-        data->fb_id = fb_cmd.fb_id;
-    } while (false);
+        return false;
+    }
 
-    printf("Using framebuffer ID: %d\n", data->fb_id);
+    return true;
+}
 
-    do {
-        struct drm_mode_map_dumb map_dumb = {
-            .handle = data->dumb_buffer.handle,
+// Finds the primary plane of the CRTC and the formats it can scan out, along with the overlay and cursor planes
+bool _SNK_DRM_findPlanes(const SNK_DRM* drm, _SNK_DRM_Data* data) {
+    if (!_SNK_DRM_setClientCap(drm, DRM_CLIENT_CAP_UNIVERSAL_PLANES)) {
+        printf("Universal planes are not supported: %s\n", strerror(errno));
+
+        return false;
+    }
+
+    struct drm_mode_get_plane_res plane_res = {};
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETPLANERESOURCES, &plane_res) == -1) {
+        printf("Failed to get DRM planes: %s\n", strerror(errno));
+
+        return false;
+    }
+
+    SNK_Vec planes = SNK_Vec_new(plane_res.count_planes, sizeof(__u32), true);
+
+    plane_res.plane_id_ptr = (__u64)SNK_Vec_data(&planes);
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETPLANERESOURCES, &plane_res) == -1) {
+        printf("Failed to get DRM planes: %s\n", strerror(errno));
+
+        SNK_Vec_free(&planes);
+
+        return false;
+    }
+
+    data->sprite_planes = SNK_Vec_new(plane_res.count_planes, sizeof(_SNK_DRM_SpritePlane), false);
+
+    for (size_t i = 0; i < SNK_Vec_size(&planes); i++) {
+        struct drm_mode_get_plane get_plane = {
+            .plane_id = *(__u32*)SNK_Vec_at(&planes, i),
         };
 
-        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_MAP_DUMB, &map_dumb) == -1) {
-            printf("Failed to map dumb buffer: %s\n", strerror(errno));
+        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETPLANE, &get_plane) == -1 ||
+            (get_plane.possible_crtcs & (1u << data->resources.crtc_index)) == 0)
+            continue;
 
-            return false;
-        }
+        _SNK_DRM_ObjectProps props = {};
 
-        printf("Framebuffer offset: %llu\n", map_dumb.offset);
+        if (!_SNK_DRM_ObjectProps_get(drm, get_plane.plane_id, DRM_MODE_OBJECT_PLANE, &props))
+            continue;
 
-        data->data =
-            mmap(nullptr, data->dumb_buffer.size, PROT_READ | PROT_WRITE, MAP_SHARED, drm->_fd, (off_t)map_dumb.offset);
+        __u64      type     = 0;
+        const bool has_type = _SNK_DRM_ObjectProps_find(drm, &props, "type", &type) != 0;
 
-        if (data->data == MAP_FAILED) {
-            printf("Failed to mmap dumb buffer: %s\n", strerror(errno));
+        _SNK_DRM_ObjectProps_free(&props);
 
-            return false;
+        if (!has_type)
+            continue;
+
+        if (type == _SNK_DRM_PLANE_TYPE_PRIMARY) {
+            if (data->primary_plane_id == 0 && _SNK_DRM_getPlaneFormats(drm, &get_plane, &data->plane_formats))
+                data->primary_plane_id = get_plane.plane_id;
+
+            continue;
         }
 
-        printf("Framebuffer data: %p\n", data->data);
-    } while (false);
+        _SNK_DRM_SpritePlane plane = {
+            .id        = get_plane.plane_id,
+            .is_cursor = type == _SNK_DRM_PLANE_TYPE_CURSOR,
+        };
+
+        if ((type == _SNK_DRM_PLANE_TYPE_OVERLAY || plane.is_cursor) &&
+            _SNK_DRM_getPlaneFormats(drm, &get_plane, &plane.formats))
+            SNK_Vec_push(&data->sprite_planes, &plane, sizeof(plane));
+    }
 
-    memset(data->data, 0, data->dumb_buffer.size);
+    SNK_Vec_free(&planes);
 
-    printf("DRM is ready\n");
+    if (data->primary_plane_id == 0) {
+        printf("No primary plane for CRTC %d\n", data->resources.crtc_id);
+
+        return false;
+    }
+
+    printf("Primary plane %d supports %lu formats\n", data->primary_plane_id, SNK_Vec_size(&data->plane_formats));
+    printf("Found %lu overlay and cursor planes\n", SNK_Vec_size(&data->sprite_planes));
 
     return true;
 }
 
-bool SNK_DRM_refresh(const SNK_DRM* drm) {
-    _SNK_DRM_ASSERT(drm);
-    ASSERT(drm->_data != nullptr);
-
-    const auto data = (_SNK_DRM_Data*)drm->_data;
+bool _SNK_DRM_hasFormat(const SNK_Vec* formats, const SNK_DRM_Format format) {
+    const __u32 fourcc = _SNK_DRM_Format_fourcc(format);
 
-    ASSERT(data->preferred_mode != nullptr);
-    ASSERT(data->fb_id != 0);
-    ASSERT(data->resources.connector_id != 0);
-    ASSERT(data->resources.crtc_id != 0);
+    for (size_t i = 0; i < SNK_Vec_size(formats); i++) {
+        if (*(__u32*)SNK_Vec_at(formats, i) == fourcc)
+            return true;
+    }
 
-    struct drm_mode_crtc crtc = {
-        .set_connectors_ptr = (__u64)&data->resources.connector_id,
-        .count_connectors   = 1,
-        .crtc_id            = data->resources.crtc_id,
-        .fb_id              = data->fb_id,
-        .x                  = 0,
-        .y                  = 0,
-        .mode_valid         = 1,
-        .mode               = *data->preferred_mode,
-    };
+    return false;
+}
 
-    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_SETCRTC, &crtc) == -1) {
-        printf("Failed to set CRTC: %s\n", strerror(errno));
+// Looks up the IDs of the plane's properties, only the damage clips may be missing
+bool _SNK_DRM_getPlaneProps(const SNK_DRM* drm, const __u32 plane_id, __u32 plane_props[_SNK_DRM_PlaneProp_Count]) {
+    _SNK_DRM_ObjectProps props = {};
 
+    if (!_SNK_DRM_ObjectProps_get(drm, plane_id, DRM_MODE_OBJECT_PLANE, &props))
         return false;
+
+    for (size_t i = 0; i < _SNK_DRM_PlaneProp_Count; i++)
+        plane_props[i] = _SNK_DRM_ObjectProps_find(drm, &props, _SNK_DRM_PLANE_PROP_NAMES[i], nullptr);
+
+    _SNK_DRM_ObjectProps_free(&props);
+
+    for (size_t i = 0; i < _SNK_DRM_PlaneProp_DamageClips; i++) {
+        if (plane_props[i] == 0) {
+            printf("Plane %d has no %s property\n", plane_id, _SNK_DRM_PLANE_PROP_NAMES[i]);
+
+            return false;
+        }
     }
 
     return true;
 }
 
-SNK_DRM_FBInfo SNK_DRM_getFBInfo(const SNK_DRM* drm) {
-    _SNK_DRM_ASSERT(drm);
-    ASSERT(drm->_data != nullptr);
+// Looks up the property IDs an atomic commit needs, the primary plane has to be known already
+bool _SNK_DRM_initAtomic(const SNK_DRM* drm, _SNK_DRM_Data* data) {
+    if (data->primary_plane_id == 0 || !_SNK_DRM_setClientCap(drm, DRM_CLIENT_CAP_ATOMIC)) {
+        printf("Atomic modesetting is not supported: %s\n", strerror(errno));
 
-    const auto data = (_SNK_DRM_Data*)drm->_data;
+        return false;
+    }
 
-    ASSERT(data->data != nullptr);
-    ASSERT(data->preferred_mode != nullptr);
-    ASSERT(data->dumb_buffer.size != 0);
+    _SNK_DRM_Atomic*     atomic = &data->atomic;
+    _SNK_DRM_ObjectProps props  = {};
 
-    return (SNK_DRM_FBInfo){
-        .width  = data->preferred_mode->hdisplay,
-        .height = data->preferred_mode->vdisplay,
-        .stride = data->dumb_buffer.pitch,
-        .size   = data->dumb_buffer.size,
-        .buffer = data->data,
-    };
-}
+    if (!_SNK_DRM_getPlaneProps(drm, data->primary_plane_id, atomic->plane_props))
+        return false;
 
-void SNK_DRM_free(SNK_DRM* drm) {
-    _SNK_DRM_ASSERT(drm);
+    if (!_SNK_DRM_ObjectProps_get(drm, data->resources.crtc_id, DRM_MODE_OBJECT_CRTC, &props))
+        return false;
 
-    if (drm->_data != nullptr) {
-        const auto data = (_SNK_DRM_Data*)drm->_data;
+    atomic->crtc_mode_id = _SNK_DRM_ObjectProps_find(drm, &props, "MODE_ID", nullptr);
+    atomic->crtc_active  = _SNK_DRM_ObjectProps_find(drm, &props, "ACTIVE", nullptr);
 
-        _SNK_DRM_Connector_free(&data->connector);
+    _SNK_DRM_ObjectProps_free(&props);
 
-        if (data->fb_id != 0) {
-            if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_RMFB, &data->fb_id) == -1)
-                printf("Failed to remove framebuffer: %s\n", strerror(errno));
-        }
+    if (!_SNK_DRM_ObjectProps_get(drm, data->resources.connector_id, DRM_MODE_OBJECT_CONNECTOR, &props))
+        return false;
 
-        if (data->dumb_buffer.handle != 0) {
-            struct drm_mode_destroy_dumb destroy_dumb = {
-                .handle = data->dumb_buffer.handle,
-            };
+    atomic->connector_crtc_id = _SNK_DRM_ObjectProps_find(drm, &props, "CRTC_ID", nullptr);
 
-            if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy_dumb) == -1)
-                printf("Failed to destroy dumb buffer: %s\n", strerror(errno));
-        }
+    _SNK_DRM_ObjectProps_free(&props);
+
+    if (atomic->crtc_mode_id == 0 || atomic->crtc_active == 0 || atomic->connector_crtc_id == 0) {
+        printf("CRTC %d or connector %d lacks atomic properties\n", data->resources.crtc_id,
+               data->resources.connector_id);
 
-        do {
-            struct drm_mode_crtc crtc = data->old_crtc;
+        return false;
+    }
+
+    printf("Using atomic modesetting with primary plane %d\n", data->primary_plane_id);
+
+    return true;
+}
+
+// Returns the ID of a new property blob holding the mode, 0 on failure
+__u32 _SNK_DRM_createModeBlob(const SNK_DRM* drm, const struct drm_mode_modeinfo* mode) {
+    struct drm_mode_create_blob create_blob = {
+        .data   = (__u64)mode,
+        .length = sizeof(*mode),
+    };
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_CREATEPROPBLOB, &create_blob) == -1) {
+        printf("Failed to create mode blob: %s\n", strerror(errno));
+
+        return 0;
+    }
+
+    return create_blob.blob_id;
+}
+
+// Lights up the CRTC in the mode with the buffer on the primary plane, which scales it up to `scale` times its size
+void _SNK_DRM_addModeset(_SNK_DRM_AtomicRequest* request, const _SNK_DRM_Data* data, const _SNK_DRM_Buffer* buffer,
+                         const __u32 mode_blob_id) {
+    const _SNK_DRM_Atomic* atomic      = &data->atomic;
+    const __u32*           plane_props = atomic->plane_props;
+
+    _SNK_DRM_AtomicRequest_add(request, data->resources.connector_id, atomic->connector_crtc_id,
+                               data->resources.crtc_id);
+    _SNK_DRM_AtomicRequest_add(request, data->resources.crtc_id, atomic->crtc_mode_id, mode_blob_id);
+    _SNK_DRM_AtomicRequest_add(request, data->resources.crtc_id, atomic->crtc_active, 1);
+    _SNK_DRM_AtomicRequest_add(request, data->primary_plane_id, plane_props[_SNK_DRM_PlaneProp_FbId], buffer->fb_id);
+    _SNK_DRM_AtomicRequest_add(request, data->primary_plane_id, plane_props[_SNK_DRM_PlaneProp_CrtcId],
+                               data->resources.crtc_id);
+    // Source coordinates are 16.16 fixed point
+    _SNK_DRM_AtomicRequest_add(request, data->primary_plane_id, plane_props[_SNK_DRM_PlaneProp_SrcX], 0);
+    _SNK_DRM_AtomicRequest_add(request, data->primary_plane_id, plane_props[_SNK_DRM_PlaneProp_SrcY], 0);
+    _SNK_DRM_AtomicRequest_add(request, data->primary_plane_id, plane_props[_SNK_DRM_PlaneProp_SrcW],
+                               (__u64)data->width << 16);
+    _SNK_DRM_AtomicRequest_add(request, data->primary_plane_id, plane_props[_SNK_DRM_PlaneProp_SrcH],
+                               (__u64)data->height << 16);
+    _SNK_DRM_AtomicRequest_add(request, data->primary_plane_id, plane_props[_SNK_DRM_PlaneProp_CrtcX], 0);
+    _SNK_DRM_AtomicRequest_add(request, data->primary_plane_id, plane_props[_SNK_DRM_PlaneProp_CrtcY], 0);
+    _SNK_DRM_AtomicRequest_add(request, data->primary_plane_id, plane_props[_SNK_DRM_PlaneProp_CrtcW],
+                               data->width * data->scale);
+    _SNK_DRM_AtomicRequest_add(request, data->primary_plane_id, plane_props[_SNK_DRM_PlaneProp_CrtcH],
+                               data->height * data->scale);
+}
+
+// Asks the driver whether it would take the modeset, which is where a plane that can't scale is found out
+bool _SNK_DRM_testModeset(const SNK_DRM* drm, const _SNK_DRM_Data* data) {
+    const __u32 mode_blob_id = _SNK_DRM_createModeBlob(drm, data->mode);
+
+    if (mode_blob_id == 0)
+        return false;
+
+    _SNK_DRM_AtomicRequest request = {};
+    _SNK_DRM_addModeset(&request, data, &data->buffers[0], mode_blob_id);
+
+    const long result =
+        _SNK_DRM_AtomicRequest_commit(drm, &request, DRM_MODE_ATOMIC_TEST_ONLY | DRM_MODE_ATOMIC_ALLOW_MODESET, 0);
+
+    struct drm_mode_destroy_blob destroy_blob = {
+        .blob_id = mode_blob_id,
+    };
+
+    _SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_DESTROYPROPBLOB, &destroy_blob);
+
+    return result != -1;
+}
+
+// Picks an encoder and CRTC for the connector, keeping the ones already driving it if there are any
+bool _SNK_DRM_findCrtc(const SNK_DRM* drm, const _SNK_DRM_Connector* connector, const __u32 current_encoder_id,
+                       const SNK_Vec* crtcs, _SNK_DRM_Resources* resources) {
+    // The current encoder comes first, then every encoder the connector can use
+    for (size_t i = 0; i <= SNK_Vec_size(&connector->encoders); i++) {
+        const __u32 encoder_id = i == 0 ? current_encoder_id : *(__u32*)SNK_Vec_at(&connector->encoders, i - 1);
+
+        if (encoder_id == 0)
+            continue;
+
+        struct drm_mode_get_encoder get_encoder = {
+            .encoder_id = encoder_id,
+        };
+
+        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETENCODER, &get_encoder) == -1)
+            continue;
+
+        for (size_t j = 0; j < SNK_Vec_size(crtcs); j++) {
+            const __u32 crtc_id    = *(__u32*)SNK_Vec_at(crtcs, j);
+            const bool  is_current = i == 0 && get_encoder.crtc_id != 0;
+
+            if (is_current ? crtc_id != get_encoder.crtc_id : (get_encoder.possible_crtcs & (1u << j)) == 0)
+                continue;
+
+            *resources = (_SNK_DRM_Resources){
+                .connector_id = connector->id,
+                .crtc_id      = crtc_id,
+                .encoder_id   = encoder_id,
+                .crtc_index   = j,
+            };
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Takes the first connected connector that has modes and a CRTC to drive it
+bool _SNK_DRM_findOutput(const SNK_DRM* drm, _SNK_DRM_Data* data) {
+    struct drm_mode_card_res card_res = {};
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETRESOURCES, &card_res) == -1) {
+        printf("Failed to get DRM resources: %s\n", strerror(errno));
+
+        return false;
+    }
+
+    SNK_Vec connectors = SNK_Vec_new(card_res.count_connectors, sizeof(__u32), true);
+    SNK_Vec crtcs      = SNK_Vec_new(card_res.count_crtcs, sizeof(__u32), true);
+    SNK_Vec encoders   = SNK_Vec_new(card_res.count_encoders, sizeof(__u32), true);
+
+    // Only the lists are wanted, the framebuffer IDs would need another buffer
+    card_res.count_fbs        = 0;
+    card_res.connector_id_ptr = (__u64)SNK_Vec_data(&connectors);
+    card_res.crtc_id_ptr      = (__u64)SNK_Vec_data(&crtcs);
+    card_res.encoder_id_ptr   = (__u64)SNK_Vec_data(&encoders);
+
+    bool is_found = false;
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETRESOURCES, &card_res) == -1) {
+        printf("Failed to get DRM resources: %s\n", strerror(errno));
+
+        SNK_Vec_clear(&connectors);
+    } else {
+        printf("Card has %lu connectors, %lu CRTCs and %lu encoders\n", SNK_Vec_size(&connectors),
+               SNK_Vec_size(&crtcs), SNK_Vec_size(&encoders));
+    }
+
+    for (size_t i = 0; i < SNK_Vec_size(&connectors) && !is_found; i++) {
+        const __u32 connector_id = *(__u32*)SNK_Vec_at(&connectors, i);
+
+        _SNK_DRM_Connector            connector = {};
+        struct drm_mode_get_connector info      = {};
+
+        if (!_SNK_DRM_Connector_get(drm, connector_id, &connector, &info))
+            continue;
+
+        if (info.connection != connector_status_connected || SNK_Vec_size(&connector.modes) == 0) {
+            printf("Connector %d is not connected\n", connector_id);
+        } else if (!_SNK_DRM_findCrtc(drm, &connector, info.encoder_id, &crtcs, &data->resources)) {
+            printf("No CRTC can drive connector %d\n", connector_id);
+        } else {
+            data->connector = connector;
+            is_found        = true;
+
+            continue;
+        }
+
+        _SNK_DRM_Connector_free(&connector);
+    }
+
+    SNK_Vec_free(&connectors);
+    SNK_Vec_free(&crtcs);
+    SNK_Vec_free(&encoders);
+
+    if (!is_found)
+        printf("No usable connector\n");
+
+    return is_found;
+}
+
+// Matches a mode name such as "1280x720", or "1280x720@60" to also require the refresh rate
+bool _SNK_DRM_isModeNamed(const struct drm_mode_modeinfo* mode, const char* name) {
+    const char*  at     = strchr(name, '@');
+    const size_t length = at != nullptr ? (size_t)(at - name) : strlen(name);
+
+    if (length >= DRM_DISPLAY_MODE_LEN || strncmp(mode->name, name, length) != 0 || mode->name[length] != '\0')
+        return false;
+
+    uint64_t refresh = 0;
+
+    return at == nullptr || (SNK_parseU64(at + 1, &refresh) && mode->vrefresh == refresh);
+}
+
+const struct drm_mode_modeinfo* _SNK_DRM_chooseMode(const _SNK_DRM_Connector* connector,
+                                                    const SNK_DRM_Options* options) {
+    ASSERT(SNK_Vec_size(&connector->modes) != 0);
+
+    const struct drm_mode_modeinfo* preferred = nullptr;
+    const struct drm_mode_modeinfo* smallest  = nullptr;
+    const struct drm_mode_modeinfo* named     = nullptr;
+
+    for (size_t i = 0; i < SNK_Vec_size(&connector->modes); i++) {
+        const auto mode = (const struct drm_mode_modeinfo*)SNK_Vec_at(&connector->modes, i);
+
+        if (preferred == nullptr && mode->type & DRM_MODE_TYPE_PREFERRED)
+            preferred = mode;
+
+        const size_t pixels = (size_t)mode->hdisplay * mode->vdisplay;
+
+        // The faster refresh of two same sized modes, nothing is gained by a slower one
+        if (smallest == nullptr || pixels < (size_t)smallest->hdisplay * smallest->vdisplay ||
+            (pixels == (size_t)smallest->hdisplay * smallest->vdisplay && mode->vrefresh > smallest->vrefresh))
+            smallest = mode;
+
+        if (named == nullptr && options->mode_name != nullptr && _SNK_DRM_isModeNamed(mode, options->mode_name))
+            named = mode;
+    }
+
+    // Modes are listed best first, so the first one stands in if none is marked preferred
+    if (preferred == nullptr)
+        preferred = SNK_Vec_at(&connector->modes, 0);
+
+    switch (options->mode_policy) {
+    case SNK_DRM_ModePolicy_Preferred:
+        return preferred;
+    case SNK_DRM_ModePolicy_Smallest:
+        return smallest;
+    case SNK_DRM_ModePolicy_Named:
+        if (named != nullptr)
+            return named;
+
+        printf("No mode called '%s', using the preferred one\n", options->mode_name);
+
+        return preferred;
+    }
+
+    SNK_crash("Unknown mode policy %d", options->mode_policy);
+}
+
+bool SNK_DRM_open(const char* device, SNK_DRM* drm) {
+    ASSERT(drm != nullptr);
+    ASSERT(device != nullptr);
+
+    const int fd = open(device, O_RDWR);
+
+    if (fd < 0)
+        return false;
+
+    drm->_fd = fd;
+
+    return true;
+}
+
+bool SNK_DRM_initFB(SNK_DRM* drm, const SNK_DRM_Options* options) {
+    _SNK_DRM_ASSERT(drm);
+    ASSERT(options != nullptr);
+    ASSERT(options->buffer_count >= 1 && options->buffer_count <= SNK_DRM_MAX_BUFFERS);
+
+    do {
+        struct drm_get_cap cap = {
+            .capability = DRM_CAP_DUMB_BUFFER,
+        };
+
+        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_GET_CAP, &cap) == -1) {
+            printf("Failed to get DRM capability: %s\n", strerror(errno));
+
+            return false;
+        }
+
+        if (cap.value == 0) {
+            printf("dumb buffer capability not supported\n");
+
+            return false;
+        }
+    } while (false);
+
+    drm->_data = calloc(1, sizeof(_SNK_DRM_Data));
+
+    if (drm->_data == nullptr)
+        SNK_crash("Failed to allocate DRM data");
+
+    const auto data = (_SNK_DRM_Data*)drm->_data;
+
+    data->front        = SIZE_MAX;
+    data->pending      = SIZE_MAX;
+    data->has_dirty_fb = true;
+
+    if (!_SNK_DRM_findOutput(drm, data))
+        return false;
+
+    _SNK_DRM_Resources_dump(&data->resources);
+
+    do {
+        struct drm_mode_crtc current_crtc = {
+            .crtc_id = data->resources.crtc_id,
+        };
+
+        if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_GETCRTC, &current_crtc) == -1) {
+            printf("Failed to get current CRTC: %s\n", strerror(errno));
+
+            return false;
+        }
+
+        data->old_crtc = current_crtc;
+    } while (false);
+
+    printf("Using connector info:\n");
+    _SNK_DRM_Connnector_dump(&data->connector);
+
+    data->mode = _SNK_DRM_chooseMode(&data->connector, options);
+
+    printf("Using mode %s@%d\n", data->mode->name, data->mode->vrefresh);
+
+    const bool has_planes = _SNK_DRM_findPlanes(drm, data);
+
+    data->format = options->format;
+
+    // XRGB8888 is the one format every driver has to support
+    if (data->format != SNK_DRM_Format_XRGB8888 && !_SNK_DRM_hasFormat(&data->plane_formats, data->format)) {
+        printf("%s is not supported by the primary plane\n", _SNK_DRM_Format_name(data->format));
+
+        data->format = SNK_DRM_Format_XRGB8888;
+    }
+
+    printf("Using pixel format %s\n", _SNK_DRM_Format_name(data->format));
+
+    data->is_atomic = options->atomic && has_planes && _SNK_DRM_initAtomic(drm, data);
+
+    if (!data->is_atomic)
+        printf("Using legacy modesetting\n");
+
+    data->scale = options->scale > 1 ? options->scale : 1;
+
+    if (data->scale > 1 && !data->is_atomic) {
+        printf("Plane scaling needs atomic modesetting\n");
+
+        data->scale = 1;
+    }
+
+    if (!_SNK_DRM_createBuffers(drm, data, options->buffer_count))
+        return false;
+
+    // Plenty of primary planes can't scale at all, or not by this much
+    if (data->scale > 1 && !_SNK_DRM_testModeset(drm, data)) {
+        printf("Primary plane can't scale by %lu, using buffers of the mode's size\n", data->scale);
+
+        _SNK_DRM_destroyBuffers(drm, data);
+
+        data->scale = 1;
+
+        if (!_SNK_DRM_createBuffers(drm, data, options->buffer_count))
+            return false;
+    }
+
+    printf("Using %lux%lu framebuffers scaled by %lu\n", data->width, data->height, data->scale);
+
+    data->shadow = calloc(1, data->buffers[0].dumb_buffer.size);
+
+    if (data->shadow == nullptr)
+        SNK_crash("Failed to allocate shadow framebuffer");
+
+    if (options->async_flip) {
+        data->async_flip =
+            _SNK_DRM_hasCap(drm, data->is_atomic ? DRM_CAP_ATOMIC_ASYNC_PAGE_FLIP : DRM_CAP_ASYNC_PAGE_FLIP);
+
+        printf(data->async_flip ? "Using async page flips\n" : "Async page flips are not supported\n");
+    }
+
+    printf("DRM is ready\n");
+
+    return true;
+}
+
+bool _SNK_DRM_handleEvents(const SNK_DRM* drm, _SNK_DRM_Data* data) {
+    char          buf[1024];
+    const ssize_t bytes = read(drm->_fd, buf, sizeof(buf));
+
+    if (bytes < 0) {
+        if (errno == EINTR || errno == EAGAIN)
+            return true;
+
+        printf("Failed to read DRM events: %s\n", strerror(errno));
+
+        return false;
+    }
+
+    for (size_t offset = 0; offset + sizeof(struct drm_event) <= (size_t)bytes;) {
+        struct drm_event event;
+        memcpy(&event, buf + offset, sizeof(event));
+
+        if (event.length < sizeof(event))
+            break;
+
+        if (event.type == DRM_EVENT_FLIP_COMPLETE && data->pending != SIZE_MAX) {
+            data->front   = data->pending;
+            data->pending = SIZE_MAX;
+        }
+
+        offset += event.length;
+    }
+
+    return true;
+}
+
+int SNK_DRM_fd(const SNK_DRM* drm) {
+    _SNK_DRM_ASSERT(drm);
+
+    return drm->_fd;
+}
+
+bool SNK_DRM_handleEvents(SNK_DRM* drm) {
+    _SNK_DRM_ASSERT(drm);
+    ASSERT(drm->_data != nullptr);
+
+    return _SNK_DRM_handleEvents(drm, (_SNK_DRM_Data*)drm->_data);
+}
+
+bool SNK_DRM_waitFlip(SNK_DRM* drm) {
+    _SNK_DRM_ASSERT(drm);
+    ASSERT(drm->_data != nullptr);
+
+    const auto data = (_SNK_DRM_Data*)drm->_data;
+
+    while (data->pending != SIZE_MAX) {
+        if (!_SNK_DRM_handleEvents(drm, data))
+            return false;
+    }
+
+    return true;
+}
+
+bool _SNK_DRM_setCrtc(const SNK_DRM* drm, const _SNK_DRM_Data* data, const __u32 fb_id) {
+    struct drm_mode_crtc crtc = {
+        .set_connectors_ptr = (__u64)&data->resources.connector_id,
+        .count_connectors   = 1,
+        .crtc_id            = data->resources.crtc_id,
+        .fb_id              = fb_id,
+        .x                  = 0,
+        .y                  = 0,
+        .mode_valid         = 1,
+        .mode               = *data->mode,
+    };
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_SETCRTC, &crtc) == -1) {
+        printf("Failed to set CRTC: %s\n", strerror(errno));
+
+        return false;
+    }
+
+    return true;
+}
+
+bool _SNK_DRM_dirtyFB(const SNK_DRM* drm, _SNK_DRM_Data* data, const _SNK_DRM_Buffer* buffer,
+                      const SNK_DRM_Rect* rects, const size_t rect_count) {
+    if (!data->has_dirty_fb)
+        return true;
+
+    struct drm_clip_rect clips[DRM_MODE_FB_DIRTY_MAX_CLIPS];
+
+    // No clips flushes the whole framebuffer, which is also what too many of them are worth
+    const size_t clip_count = rect_count <= DRM_MODE_FB_DIRTY_MAX_CLIPS ? rect_count : 0;
+
+    for (size_t i = 0; i < clip_count; i++) {
+        clips[i] = (struct drm_clip_rect){
+            .x1 = rects[i].x1,
+            .y1 = rects[i].y1,
+            .x2 = rects[i].x2,
+            .y2 = rects[i].y2,
+        };
+    }
+
+    struct drm_mode_fb_dirty_cmd dirty = {
+        .fb_id     = buffer->fb_id,
+        .num_clips = clip_count,
+        .clips_ptr = clip_count != 0 ? (__u64)clips : 0,
+    };
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_DIRTYFB, &dirty) == -1) {
+        if (errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP) {
+            printf("DIRTYFB is not supported, presenting without damage\n");
+
+            data->has_dirty_fb = false;
+
+            return true;
+        }
+
+        printf("Failed to flush framebuffer damage: %s\n", strerror(errno));
+
+        return false;
+    }
+
+    return true;
+}
+
+// Places every sprite, or only the ones that moved since, on its plane. Returns whether any were added.
+bool _SNK_DRM_addSprites(_SNK_DRM_AtomicRequest* request, _SNK_DRM_Data* data, const bool all) {
+    bool is_added = false;
+
+    for (size_t i = 0; i < data->sprite_count; i++) {
+        _SNK_DRM_Sprite* sprite = &data->sprites[i];
+
+        if (!all && !sprite->is_dirty)
+            continue;
+
+        const __u32  id    = sprite->plane_id;
+        const __u32* props = sprite->plane_props;
+
+        sprite->is_dirty = false;
+        is_added         = true;
+
+        // A sprite that was never moved keeps its plane off
+        if (!sprite->is_visible) {
+            _SNK_DRM_AtomicRequest_add(request, id, props[_SNK_DRM_PlaneProp_FbId], 0);
+            _SNK_DRM_AtomicRequest_add(request, id, props[_SNK_DRM_PlaneProp_CrtcId], 0);
+
+            continue;
+        }
+
+        _SNK_DRM_AtomicRequest_add(request, id, props[_SNK_DRM_PlaneProp_FbId], sprite->buffer.fb_id);
+        _SNK_DRM_AtomicRequest_add(request, id, props[_SNK_DRM_PlaneProp_CrtcId], data->resources.crtc_id);
+        _SNK_DRM_AtomicRequest_add(request, id, props[_SNK_DRM_PlaneProp_SrcX], 0);
+        _SNK_DRM_AtomicRequest_add(request, id, props[_SNK_DRM_PlaneProp_SrcY], 0);
+        _SNK_DRM_AtomicRequest_add(request, id, props[_SNK_DRM_PlaneProp_SrcW], (__u64)sprite->buffer_width << 16);
+        _SNK_DRM_AtomicRequest_add(request, id, props[_SNK_DRM_PlaneProp_SrcH], (__u64)sprite->buffer_height << 16);
+        // CRTC coordinates are signed, sprites may hang off the edges
+        _SNK_DRM_AtomicRequest_add(request, id, props[_SNK_DRM_PlaneProp_CrtcX],
+                                   (__u64)((int64_t)sprite->x * (int64_t)data->scale));
+        _SNK_DRM_AtomicRequest_add(request, id, props[_SNK_DRM_PlaneProp_CrtcY],
+                                   (__u64)((int64_t)sprite->y * (int64_t)data->scale));
+        _SNK_DRM_AtomicRequest_add(request, id, props[_SNK_DRM_PlaneProp_CrtcW], sprite->buffer_width);
+        _SNK_DRM_AtomicRequest_add(request, id, props[_SNK_DRM_PlaneProp_CrtcH], sprite->buffer_height);
+    }
+
+    return is_added;
+}
+
+// Moves the sprites without a page flip, for a single buffer that is never flipped
+bool _SNK_DRM_commitSprites(const SNK_DRM* drm, _SNK_DRM_Data* data) {
+    _SNK_DRM_AtomicRequest request = {};
+
+    if (!_SNK_DRM_addSprites(&request, data, false))
+        return true;
+
+    if (_SNK_DRM_AtomicRequest_commit(drm, &request, 0, 0) == -1) {
+        printf("Failed to commit sprites: %s\n", strerror(errno));
+
+        return false;
+    }
+
+    return true;
+}
+
+void _SNK_DRM_freeSprites(const SNK_DRM* drm, _SNK_DRM_Data* data) {
+    for (size_t i = 0; i < data->sprite_count; i++)
+        _SNK_DRM_Buffer_destroy(drm, &data->sprites[i].buffer);
+
+    data->sprite_count = 0;
+}
+
+bool _SNK_DRM_atomicModeset(const SNK_DRM* drm, _SNK_DRM_Data* data, const _SNK_DRM_Buffer* buffer) {
+    _SNK_DRM_Atomic* atomic = &data->atomic;
+
+    const __u32 mode_blob_id = _SNK_DRM_createModeBlob(drm, data->mode);
+
+    if (mode_blob_id == 0)
+        return false;
+
+    _SNK_DRM_AtomicRequest request = {};
+
+    _SNK_DRM_addModeset(&request, data, buffer, mode_blob_id);
+    _SNK_DRM_addSprites(&request, data, true);
+
+    if (_SNK_DRM_AtomicRequest_commit(drm, &request, DRM_MODE_ATOMIC_ALLOW_MODESET, 0) == -1) {
+        printf("Failed to commit atomic modeset: %s\n", strerror(errno));
+
+        struct drm_mode_destroy_blob destroy_blob = {
+            .blob_id = mode_blob_id,
+        };
+
+        _SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_DESTROYPROPBLOB, &destroy_blob);
+
+        return false;
+    }
+
+    if (atomic->mode_blob_id != 0) {
+        struct drm_mode_destroy_blob destroy_blob = {
+            .blob_id = atomic->mode_blob_id,
+        };
+
+        _SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_DESTROYPROPBLOB, &destroy_blob);
+    }
+
+    atomic->mode_blob_id = mode_blob_id;
+
+    return true;
+}
+
+bool _SNK_DRM_modeset(const SNK_DRM* drm, _SNK_DRM_Data* data, const _SNK_DRM_Buffer* buffer) {
+    if (data->is_atomic) {
+        if (_SNK_DRM_atomicModeset(drm, data, buffer))
+            return true;
+
+        // Planes that can't be enabled together are the likeliest reason, the framebuffer has to show regardless
+        if (data->sprite_count != 0) {
+            printf("Retrying the modeset without sprites\n");
+
+            _SNK_DRM_freeSprites(drm, data);
+
+            if (_SNK_DRM_atomicModeset(drm, data, buffer))
+                return true;
+        }
+
+        // SETCRTC scans out the buffer as is, one smaller than the mode doesn't fill it
+        if (data->scale > 1) {
+            printf("Scaled framebuffers need atomic modesetting\n");
+
+            return false;
+        }
+
+        printf("Falling back to legacy modesetting\n");
+
+        data->is_atomic  = false;
+        data->async_flip = data->async_flip && _SNK_DRM_hasCap(drm, DRM_CAP_ASYNC_PAGE_FLIP);
+    }
+
+    return _SNK_DRM_setCrtc(drm, data, buffer->fb_id);
+}
+
+bool _SNK_DRM_atomicFlip(const SNK_DRM* drm, _SNK_DRM_Data* data, const size_t index, const SNK_DRM_Rect* rects,
+                         const size_t rect_count) {
+    const _SNK_DRM_Atomic* atomic      = &data->atomic;
+    const __u32            damage_prop = atomic->plane_props[_SNK_DRM_PlaneProp_DamageClips];
+
+    _SNK_DRM_AtomicRequest request = {};
+
+    _SNK_DRM_AtomicRequest_add(&request, data->primary_plane_id, atomic->plane_props[_SNK_DRM_PlaneProp_FbId],
+                               data->buffers[index].fb_id);
+
+    // Async commits may only change FB_ID, so their damage goes through DIRTYFB like on planes without damage clips
+    struct drm_mode_create_blob damage_blob = {};
+
+    if (damage_prop != 0 && !data->async_flip) {
+        if (rect_count != 0 && rect_count <= DRM_MODE_FB_DIRTY_MAX_CLIPS) {
+            struct drm_mode_rect clips[DRM_MODE_FB_DIRTY_MAX_CLIPS];
+
+            for (size_t i = 0; i < rect_count; i++) {
+                clips[i] = (struct drm_mode_rect){
+                    .x1 = rects[i].x1,
+                    .y1 = rects[i].y1,
+                    .x2 = rects[i].x2,
+                    .y2 = rects[i].y2,
+                };
+            }
+
+            damage_blob.data   = (__u64)clips;
+            damage_blob.length = rect_count * sizeof(struct drm_mode_rect);
+
+            if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_CREATEPROPBLOB, &damage_blob) == -1) {
+                printf("Failed to create damage blob: %s\n", strerror(errno));
+
+                return false;
+            }
+
+            _SNK_DRM_AtomicRequest_add(&request, data->primary_plane_id, damage_prop, damage_blob.blob_id);
+        }
+    } else if (!_SNK_DRM_dirtyFB(drm, data, &data->buffers[index], rects, rect_count)) {
+        return false;
+    }
+
+    // Moving a sprite changes more than FB_ID, so that flip waits for vblank
+    const bool has_sprites = _SNK_DRM_addSprites(&request, data, false);
+
+    const __u32 flags       = DRM_MODE_ATOMIC_NONBLOCK | DRM_MODE_PAGE_FLIP_EVENT;
+    const __u32 async_flags = data->async_flip && !has_sprites ? DRM_MODE_PAGE_FLIP_ASYNC : 0;
+
+    long result = _SNK_DRM_AtomicRequest_commit(drm, &request, flags | async_flags, index);
+
+    if (result == -1 && errno == EINVAL && async_flags != 0) {
+        printf("Async page flip rejected, waiting for vblank from now on\n");
+
+        data->async_flip = false;
+
+        result = _SNK_DRM_AtomicRequest_commit(drm, &request, flags, index);
+    }
+
+    if (result == -1)
+        printf("Failed to commit atomic page flip: %s\n", strerror(errno));
+
+    // The commit holds its own reference to the damage
+    if (damage_blob.blob_id != 0) {
+        struct drm_mode_destroy_blob destroy_blob = {
+            .blob_id = damage_blob.blob_id,
+        };
+
+        _SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_DESTROYPROPBLOB, &destroy_blob);
+    }
+
+    return result != -1;
+}
+
+bool _SNK_DRM_legacyFlip(const SNK_DRM* drm, _SNK_DRM_Data* data, const size_t index, const SNK_DRM_Rect* rects,
+                         const size_t rect_count) {
+    if (!_SNK_DRM_dirtyFB(drm, data, &data->buffers[index], rects, rect_count))
+        return false;
+
+    struct drm_mode_crtc_page_flip flip = {
+        .crtc_id   = data->resources.crtc_id,
+        .fb_id     = data->buffers[index].fb_id,
+        .flags     = DRM_MODE_PAGE_FLIP_EVENT,
+        .user_data = index,
+    };
+
+    if (data->async_flip)
+        flip.flags |= DRM_MODE_PAGE_FLIP_ASYNC;
+
+    long result = _SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_PAGE_FLIP, &flip);
+
+    if (result == -1 && errno == EINVAL && data->async_flip) {
+        printf("Async page flip rejected, waiting for vblank from now on\n");
+
+        data->async_flip = false;
+        flip.flags       = DRM_MODE_PAGE_FLIP_EVENT;
+
+        result = _SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_PAGE_FLIP, &flip);
+    }
+
+    if (result == -1) {
+        printf("Failed to queue page flip: %s\n", strerror(errno));
+
+        return false;
+    }
+
+    return true;
+}
+
+bool SNK_DRM_present(SNK_DRM* drm, const SNK_DRM_Rect* rects, const size_t rect_count) {
+    _SNK_DRM_ASSERT(drm);
+    ASSERT(drm->_data != nullptr);
+
+    const auto data = (_SNK_DRM_Data*)drm->_data;
+
+    ASSERT(data->mode != nullptr);
+    ASSERT(data->buffer_count != 0);
+    ASSERT(data->resources.connector_id != 0);
+    ASSERT(data->resources.crtc_id != 0);
+    ASSERT(rects != nullptr || rect_count == 0);
+
+    const _SNK_DRM_Buffer* back = &data->buffers[data->back];
+
+    // Only a mode change needs a modeset, every other frame just updates or swaps the scanout buffer
+    if (data->active_mode != data->mode) {
+        if (!SNK_DRM_waitFlip(drm) || !_SNK_DRM_modeset(drm, data, back))
+            return false;
+
+        data->active_mode = data->mode;
+        data->front       = data->back;
+    } else if (data->buffer_count == 1) {
+        // A single buffer is drawn while being scanned out, shadow buffered drivers only need to copy the damage
+        return _SNK_DRM_dirtyFB(drm, data, back, rects, rect_count) && _SNK_DRM_commitSprites(drm, data);
+    } else {
+        // Only one flip can be queued at a time
+        if (!SNK_DRM_waitFlip(drm))
+            return false;
+
+        const bool is_flipped = data->is_atomic ? _SNK_DRM_atomicFlip(drm, data, data->back, rects, rect_count)
+                                                : _SNK_DRM_legacyFlip(drm, data, data->back, rects, rect_count);
+
+        if (!is_flipped)
+            return false;
+
+        data->pending = data->back;
+    }
+
+    data->back = (data->back + 1) % data->buffer_count;
+
+    return true;
+}
+
+SNK_DRM_FBInfo SNK_DRM_getFBInfo(SNK_DRM* drm) {
+    _SNK_DRM_ASSERT(drm);
+    ASSERT(drm->_data != nullptr);
+
+    const auto data = (_SNK_DRM_Data*)drm->_data;
+
+    ASSERT(data->mode != nullptr);
+    ASSERT(data->buffer_count != 0);
+
+    // With two buffers the back one is still on screen until the queued flip lands
+    if (data->buffer_count > 1 && data->back == data->front && !SNK_DRM_waitFlip(drm))
+        SNK_crash("Failed to wait for page flip");
+
+    const _SNK_DRM_Buffer* back = &data->buffers[data->back];
+
+    ASSERT(back->data != nullptr);
+    ASSERT(back->dumb_buffer.size != 0);
+
+    return (SNK_DRM_FBInfo){
+        .width  = data->width,
+        .height = data->height,
+        .stride = back->dumb_buffer.pitch,
+        .size   = back->dumb_buffer.size,
+        .buffer = back->data,
+        .shadow = data->shadow,
+        .format = data->format,
+        .index  = data->back,
+    };
+}
+
+size_t SNK_DRM_scale(const SNK_DRM* drm) {
+    _SNK_DRM_ASSERT(drm);
+    ASSERT(drm->_data != nullptr);
+
+    return ((const _SNK_DRM_Data*)drm->_data)->scale;
+}
+
+// Gives the sprite a buffer in a format its plane can blend, on cursor planes one of the cursor size
+bool _SNK_DRM_Sprite_create(const SNK_DRM* drm, const _SNK_DRM_SpritePlane* plane, const size_t width,
+                            const size_t height, _SNK_DRM_Sprite* sprite) {
+    *sprite = (_SNK_DRM_Sprite){
+        .plane_id      = plane->id,
+        .format        = SNK_DRM_Format_ARGB8888,
+        .width         = width,
+        .height        = height,
+        .buffer_width  = width,
+        .buffer_height = height,
+    };
+
+    if (plane->is_cursor) {
+        sprite->buffer_width  = _SNK_DRM_getCap(drm, DRM_CAP_CURSOR_WIDTH, _SNK_DRM_DEFAULT_CURSOR_SIZE);
+        sprite->buffer_height = _SNK_DRM_getCap(drm, DRM_CAP_CURSOR_HEIGHT, _SNK_DRM_DEFAULT_CURSOR_SIZE);
+
+        // The padding is what needs the alpha channel
+        if (width > sprite->buffer_width || height > sprite->buffer_height ||
+            !_SNK_DRM_hasFormat(&plane->formats, SNK_DRM_Format_ARGB8888))
+            return false;
+    } else if (!_SNK_DRM_hasFormat(&plane->formats, SNK_DRM_Format_ARGB8888)) {
+        if (!_SNK_DRM_hasFormat(&plane->formats, SNK_DRM_Format_XRGB8888))
+            return false;
+
+        sprite->format = SNK_DRM_Format_XRGB8888;
+    }
+
+    if (!_SNK_DRM_getPlaneProps(drm, plane->id, sprite->plane_props))
+        return false;
+
+    // New buffers are cleared, which is transparent in ARGB8888
+    if (!_SNK_DRM_Buffer_create(drm, sprite->buffer_width, sprite->buffer_height, sprite->format, &sprite->buffer)) {
+        _SNK_DRM_Buffer_destroy(drm, &sprite->buffer);
+
+        return false;
+    }
+
+    return true;
+}
+
+size_t SNK_DRM_initSprites(SNK_DRM* drm, const size_t count, const size_t width, const size_t height) {
+    _SNK_DRM_ASSERT(drm);
+    ASSERT(drm->_data != nullptr);
+    ASSERT(count <= SNK_DRM_MAX_SPRITES);
+    ASSERT(width != 0 && height != 0);
+
+    const auto data = (_SNK_DRM_Data*)drm->_data;
+
+    ASSERT(data->sprite_count == 0);
+
+    if (!data->is_atomic) {
+        printf("Sprites need atomic modesetting, drawing them into the framebuffer\n");
+
+        return 0;
+    }
+
+    // Overlays take buffers of any size, so they go first and cursor planes take what is left
+    for (size_t pass = 0; pass < 2; pass++) {
+        const bool is_cursor = pass == 1;
+
+        for (size_t i = 0; i < SNK_Vec_size(&data->sprite_planes) && data->sprite_count < count; i++) {
+            const _SNK_DRM_SpritePlane* plane  = SNK_Vec_at(&data->sprite_planes, i);
+            _SNK_DRM_Sprite*            sprite = &data->sprites[data->sprite_count];
+
+            // Images are at the display's resolution, a scaled framebuffer's pixels are `scale` of them across
+            if (plane->is_cursor != is_cursor ||
+                !_SNK_DRM_Sprite_create(drm, plane, width * data->scale, height * data->scale, sprite))
+                continue;
+
+            printf("Sprite %lu on %s plane %d\n", data->sprite_count, is_cursor ? "cursor" : "overlay", plane->id);
+
+            data->sprite_count++;
+        }
+    }
+
+    printf("Using %lu of %lu sprites\n", data->sprite_count, count);
+
+    return data->sprite_count;
+}
+
+size_t SNK_DRM_spriteCount(const SNK_DRM* drm) {
+    _SNK_DRM_ASSERT(drm);
+    ASSERT(drm->_data != nullptr);
+
+    return ((const _SNK_DRM_Data*)drm->_data)->sprite_count;
+}
+
+SNK_DRM_FBInfo SNK_DRM_getSpriteInfo(SNK_DRM* drm, const size_t sprite) {
+    _SNK_DRM_ASSERT(drm);
+    ASSERT(drm->_data != nullptr);
+
+    const auto data = (_SNK_DRM_Data*)drm->_data;
+
+    ASSERT(sprite < data->sprite_count);
+
+    const _SNK_DRM_Sprite* info = &data->sprites[sprite];
+
+    return (SNK_DRM_FBInfo){
+        .width  = info->width,
+        .height = info->height,
+        .stride = info->buffer.dumb_buffer.pitch,
+        .size   = info->buffer.dumb_buffer.size,
+        .buffer = info->buffer.data,
+        .format = info->format,
+        .index  = sprite,
+    };
+}
+
+bool SNK_DRM_moveSprite(SNK_DRM* drm, const size_t sprite, const int32_t x, const int32_t y) {
+    _SNK_DRM_ASSERT(drm);
+    ASSERT(drm->_data != nullptr);
+
+    const auto data = (_SNK_DRM_Data*)drm->_data;
+
+    ASSERT(sprite < data->sprite_count);
+
+    _SNK_DRM_Sprite* info = &data->sprites[sprite];
+
+    if (info->is_visible && info->x == x && info->y == y)
+        return false;
+
+    info->x          = x;
+    info->y          = y;
+    info->is_visible = true;
+    info->is_dirty   = true;
+
+    return true;
+}
+
+// Puts the console's own framebuffer back on the CRTC, or disables it if there was none
+void _SNK_DRM_restoreCrtc(const SNK_DRM* drm, const _SNK_DRM_Data* data) {
+    const struct drm_mode_crtc* old_crtc = &data->old_crtc;
+
+    struct drm_mode_crtc crtc = {
+        .set_connectors_ptr = (__u64)&data->resources.connector_id,
+        .count_connectors   = old_crtc->fb_id != 0 ? 1 : 0,
+        .crtc_id            = data->resources.crtc_id,
+        .fb_id              = old_crtc->fb_id,
+        .x                  = old_crtc->x,
+        .y                  = old_crtc->y,
+        .mode_valid         = old_crtc->fb_id != 0 ? old_crtc->mode_valid : 0,
+        .mode               = old_crtc->mode,
+    };
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_SETCRTC, &crtc) == -1)
+        printf("Failed to restore CRTC: %s\n", strerror(errno));
+}
+
+bool SNK_DRM_release(SNK_DRM* drm) {
+    _SNK_DRM_ASSERT(drm);
+    ASSERT(drm->_data != nullptr);
+
+    const auto data = (_SNK_DRM_Data*)drm->_data;
+
+    if (!SNK_DRM_waitFlip(drm))
+        return false;
+
+    // Removing their framebuffers takes the sprites off their planes, SETCRTC only touches the primary one
+    _SNK_DRM_freeSprites(drm, data);
+
+    _SNK_DRM_restoreCrtc(drm, data);
+
+    // Without a master the kernel's console goes back to drawing into its framebuffer
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_DROP_MASTER, nullptr) == -1) {
+        printf("Failed to drop DRM master: %s\n", strerror(errno));
+
+        return false;
+    }
+
+    data->active_mode = nullptr;
+
+    return true;
+}
+
+bool SNK_DRM_resetFB(SNK_DRM* drm) {
+    _SNK_DRM_ASSERT(drm);
+    ASSERT(drm->_data != nullptr);
+
+    const auto data = (_SNK_DRM_Data*)drm->_data;
+
+    if (_SNK_DRM_ioctl(drm, DRM_IOCTL_SET_MASTER, nullptr) == -1) {
+        printf("Failed to become DRM master: %s\n", strerror(errno));
+
+        return false;
+    }
+
+    // No flip can be pending since the release, the first present is a modeset again
+    data->back        = 0;
+    data->front       = SIZE_MAX;
+    data->pending     = SIZE_MAX;
+    data->active_mode = nullptr;
+
+    return true;
+}
+
+void SNK_DRM_free(SNK_DRM* drm) {
+    _SNK_DRM_ASSERT(drm);
+
+    if (drm->_data != nullptr) {
+        const auto data = (_SNK_DRM_Data*)drm->_data;
+
+        if (!SNK_DRM_waitFlip(drm))
+            printf("Failed to wait for page flip\n");
+
+        _SNK_DRM_freeSprites(drm, data);
+
+        // Still scanning out of our buffers unless SNK_DRM_release already handed the display back
+        if (data->active_mode != nullptr)
+            _SNK_DRM_restoreCrtc(drm, data);
+
+        _SNK_DRM_destroyBuffers(drm, data);
+
+        if (data->atomic.mode_blob_id != 0) {
+            struct drm_mode_destroy_blob destroy_blob = {
+                .blob_id = data->atomic.mode_blob_id,
+            };
+
+            if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_DESTROYPROPBLOB, &destroy_blob) == -1)
+                printf("Failed to destroy mode blob: %s\n", strerror(errno));
+        }
+
+        _SNK_DRM_Connector_free(&data->connector);
+        SNK_Vec_free(&data->plane_formats);
 
-            crtc.set_connectors_ptr = (__u64)&data->resources.connector_id;
-            crtc.count_connectors   = 1;
+        for (size_t i = 0; i < SNK_Vec_size(&data->sprite_planes); i++)
+            SNK_Vec_free(&((_SNK_DRM_SpritePlane*)SNK_Vec_at(&data->sprite_planes, i))->formats);
 
-            if (_SNK_DRM_ioctl(drm, DRM_IOCTL_MODE_SETCRTC, &crtc) == -1)
-                printf("Failed to reset CRTC: %s\n", strerror(errno));
-        } while (false);
+        SNK_Vec_free(&data->sprite_planes);
 
+        free(data->shadow);
         free(drm->_data);
         drm->_data = nullptr;
     }
@@ -11,20 +11,112 @@ typedef struct {
 
 bool SNK_DRM_open(const char* device, SNK_DRM* drm);
 
-bool SNK_DRM_initFB(SNK_DRM* drm);
+static constexpr size_t SNK_DRM_MAX_BUFFERS = 3;
 
-bool SNK_DRM_refresh(const SNK_DRM* drm);
+typedef enum {
+    SNK_DRM_Format_XRGB8888,
+    // Half the memory traffic of XRGB8888, enough for the few colors the game uses
+    SNK_DRM_Format_RGB565,
+    // XRGB8888 with alpha, for sprites on planes that need to be transparent around the image
+    SNK_DRM_Format_ARGB8888,
+} SNK_DRM_Format;
 
-void SNK_DRM_resetFB(const SNK_DRM* drm);
+size_t SNK_DRM_Format_bytesPerPixel(SNK_DRM_Format format);
+
+// How SNK_DRM_initFB picks the connector's mode
+typedef enum {
+    // The display's native mode
+    SNK_DRM_ModePolicy_Preferred,
+    // The mode with the fewest pixels, the cheapest to fill
+    SNK_DRM_ModePolicy_Smallest,
+    // The mode called SNK_DRM_Options.mode_name
+    SNK_DRM_ModePolicy_Named,
+} SNK_DRM_ModePolicy;
+
+typedef struct {
+    // 1 draws straight into the scanout buffer, 2 or 3 page flip between them
+    size_t buffer_count;
+    // Present with atomic commits when the driver supports them, the legacy ioctls otherwise
+    bool atomic;
+    // Flip as soon as a frame is ready instead of at the next vblank, trading tearing for latency
+    bool async_flip;
+    // Preferred pixel format, XRGB8888 is used if the primary plane doesn't support it
+    SNK_DRM_Format     format;
+    SNK_DRM_ModePolicy mode_policy;
+    // Such as "1280x720" or "1280x720@60", the preferred mode is used if the connector has none by that name
+    const char* mode_name;
+    // Scan out buffers this many times smaller than the mode and have the primary plane scale them up, so there is
+    // that much less to fill. Needs atomic modesetting and a plane that can scale, 0 or 1 for buffers of the mode's
+    // size, which are also used when the plane can't.
+    size_t scale;
+} SNK_DRM_Options;
+
+bool SNK_DRM_initFB(SNK_DRM* drm, const SNK_DRM_Options* options);
+
+// Damaged area in pixels, x2 and y2 are exclusive
+typedef struct {
+    uint16_t x1;
+    uint16_t y1;
+    uint16_t x2;
+    uint16_t y2;
+} SNK_DRM_Rect;
+
+// Shows the back buffer: a modeset when the mode changes, a page flip completed by a flip event otherwise.
+// The rects tell shadow buffered drivers what changed since the buffer was last presented, none means all of it.
+bool SNK_DRM_present(SNK_DRM* drm, const SNK_DRM_Rect* rects, size_t rect_count);
+
+// Blocks until the queued page flip, if any, has been scanned out
+bool SNK_DRM_waitFlip(SNK_DRM* drm);
+
+// Readable once a queued page flip completes, for an event loop to wait on along with other sources
+int SNK_DRM_fd(const SNK_DRM* drm);
+
+// Takes in the completed page flips, without blocking when SNK_DRM_fd is readable
+bool SNK_DRM_handleEvents(SNK_DRM* drm);
 
 typedef struct {
     size_t    width;
     size_t    height;
     size_t    stride;
     size_t    size;
-    uint32_t* buffer;
+    void*     buffer;
+    // Cached buffer with the same layout, shared by all framebuffers, to draw into and copy from
+    void*          shadow;
+    SNK_DRM_Format format;
+    // Which of the framebuffers this is, contents persist per index between frames
+    size_t index;
 } SNK_DRM_FBInfo;
 
-SNK_DRM_FBInfo SNK_DRM_getFBInfo(const SNK_DRM* drm);
+// Returns the back buffer to draw the next frame into, waiting for a flip if it is still on screen
+SNK_DRM_FBInfo SNK_DRM_getFBInfo(SNK_DRM* drm);
+
+// How many display pixels across each framebuffer pixel covers, 1 unless the primary plane scales it up
+size_t SNK_DRM_scale(const SNK_DRM* drm);
+
+static constexpr size_t SNK_DRM_MAX_SPRITES = 2;
+
+// Puts up to `count` sprites of width x height framebuffer pixels on overlay or cursor planes of their own, which the
+// display composites over the framebuffer. Returns how many the hardware has planes for, sprites need atomic
+// modesetting.
+size_t SNK_DRM_initSprites(SNK_DRM* drm, size_t count, size_t width, size_t height);
+
+// Sprites the display still shows, drops to 0 when the modeset turns out not to allow them
+size_t SNK_DRM_spriteCount(const SNK_DRM* drm);
+
+// Returns the sprite's image to draw into once, it has no shadow buffer and stays hidden until it is first moved.
+// The image is at the display's resolution, so it is larger than the sprite when the framebuffer is scaled.
+SNK_DRM_FBInfo SNK_DRM_getSpriteInfo(SNK_DRM* drm, size_t sprite);
+
+// Shows the sprite with its top left corner at x, y from the next present on, without touching the framebuffer.
+// Returns whether that is a change, and so needs a present.
+bool SNK_DRM_moveSprite(SNK_DRM* drm, size_t sprite, int32_t x, int32_t y);
+
+// Gives the display back to the console until SNK_DRM_resetFB, keeping the framebuffers, their mappings and the mode.
+// Sprites are freed, they have to be set up again after the reset.
+bool SNK_DRM_release(SNK_DRM* drm);
+
+// Takes the display back after SNK_DRM_release, the next present sets the mode again. The framebuffers keep what was
+// last drawn into them.
+bool SNK_DRM_resetFB(SNK_DRM* drm);
 
 void SNK_DRM_free(SNK_DRM* drm);
@@ -0,0 +1,170 @@
+#include "font.h"
+#include "blit.h"
+#include "utils.h"
+#include <stdio.h>
+
+// Columns of blank space after every glyph, part of the glyph's cell so text is drawn as one opaque strip
+constexpr size_t _SNK_FONT_SPACING = 1;
+
+constexpr char _SNK_FONT_FIRST_CHAR = ' ';
+constexpr char _SNK_FONT_LAST_CHAR  = '_';
+
+constexpr size_t _SNK_FONT_GLYPH_COUNT = _SNK_FONT_LAST_CHAR - _SNK_FONT_FIRST_CHAR + 1;
+
+// One byte per row, the low SNK_FONT_GLYPH_WIDTH bits from left to right; missing glyphs are blank
+const uint8_t _SNK_FONT_GLYPHS[_SNK_FONT_GLYPH_COUNT][SNK_FONT_GLYPH_HEIGHT] = {
+    ['!' - ' '] = {0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00000, 0b00100},
+    ['-' - ' '] = {0b00000, 0b00000, 0b00000, 0b11111, 0b00000, 0b00000, 0b00000},
+    ['.' - ' '] = {0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b01100, 0b01100},
+    ['/' - ' '] = {0b00000, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b00000},
+    ['0' - ' '] = {0b01110, 0b10001, 0b10011, 0b10101, 0b11001, 0b10001, 0b01110},
+    ['1' - ' '] = {0b00100, 0b01100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110},
+    ['2' - ' '] = {0b01110, 0b10001, 0b00001, 0b00010, 0b00100, 0b01000, 0b11111},
+    ['3' - ' '] = {0b11111, 0b00010, 0b00100, 0b00010, 0b00001, 0b10001, 0b01110},
+    ['4' - ' '] = {0b00010, 0b00110, 0b01010, 0b10010, 0b11111, 0b00010, 0b00010},
+    ['5' - ' '] = {0b11111, 0b10000, 0b11110, 0b00001, 0b00001, 0b10001, 0b01110},
+    ['6' - ' '] = {0b00110, 0b01000, 0b10000, 0b11110, 0b10001, 0b10001, 0b01110},
+    ['7' - ' '] = {0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b01000, 0b01000},
+    ['8' - ' '] = {0b01110, 0b10001, 0b10001, 0b01110, 0b10001, 0b10001, 0b01110},
+    ['9' - ' '] = {0b01110, 0b10001, 0b10001, 0b01111, 0b00001, 0b00010, 0b01100},
+    [':' - ' '] = {0b00000, 0b01100, 0b01100, 0b00000, 0b01100, 0b01100, 0b00000},
+    ['?' - ' '] = {0b01110, 0b10001, 0b00001, 0b00010, 0b00100, 0b00000, 0b00100},
+    ['A' - ' '] = {0b01110, 0b10001, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001},
+    ['B' - ' '] = {0b11110, 0b10001, 0b10001, 0b11110, 0b10001, 0b10001, 0b11110},
+    ['C' - ' '] = {0b01110, 0b10001, 0b10000, 0b10000, 0b10000, 0b10001, 0b01110},
+    ['D' - ' '] = {0b11100, 0b10010, 0b10001, 0b10001, 0b10001, 0b10010, 0b11100},
+    ['E' - ' '] = {0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b11111},
+    ['F' - ' '] = {0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b10000},
+    ['G' - ' '] = {0b01110, 0b10001, 0b10000, 0b10111, 0b10001, 0b10001, 0b01111},
+    ['H' - ' '] = {0b10001, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001},
+    ['I' - ' '] = {0b01110, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110},
+    ['J' - ' '] = {0b00111, 0b00010, 0b00010, 0b00010, 0b00010, 0b10010, 0b01100},
+    ['K' - ' '] = {0b10001, 0b10010, 0b10100, 0b11000, 0b10100, 0b10010, 0b10001},
+    ['L' - ' '] = {0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b11111},
+    ['M' - ' '] = {0b10001, 0b11011, 0b10101, 0b10101, 0b10001, 0b10001, 0b10001},
+    ['N' - ' '] = {0b10001, 0b10001, 0b11001, 0b10101, 0b10011, 0b10001, 0b10001},
+    ['O' - ' '] = {0b01110, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110},
+    ['P' - ' '] = {0b11110, 0b10001, 0b10001, 0b11110, 0b10000, 0b10000, 0b10000},
+    ['Q' - ' '] = {0b01110, 0b10001, 0b10001, 0b10001, 0b10101, 0b10010, 0b01101},
+    ['R' - ' '] = {0b11110, 0b10001, 0b10001, 0b11110, 0b10100, 0b10010, 0b10001},
+    ['S' - ' '] = {0b01111, 0b10000, 0b10000, 0b01110, 0b00001, 0b00001, 0b11110},
+    ['T' - ' '] = {0b11111, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100},
+    ['U' - ' '] = {0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110},
+    ['V' - ' '] = {0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01010, 0b00100},
+    ['W' - ' '] = {0b10001, 0b10001, 0b10001, 0b10101, 0b10101, 0b10101, 0b01010},
+    ['X' - ' '] = {0b10001, 0b10001, 0b01010, 0b00100, 0b01010, 0b10001, 0b10001},
+    ['Y' - ' '] = {0b10001, 0b10001, 0b10001, 0b01010, 0b00100, 0b00100, 0b00100},
+    ['Z' - ' '] = {0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b11111},
+};
+
+size_t _SNK_Font_glyphIndex(char c) {
+    if (c >= 'a' && c <= 'z')
+        c = (char)(c - 'a' + 'A');
+
+    if (c < _SNK_FONT_FIRST_CHAR || c > _SNK_FONT_LAST_CHAR)
+        c = '?';
+
+    return (size_t)(c - _SNK_FONT_FIRST_CHAR);
+}
+
+SNK_Font SNK_Font_new(const SNK_DRM_Format format, const size_t scale, const uint32_t foreground,
+                      const uint32_t background) {
+    ASSERT(scale != 0);
+
+    const size_t bytes_per_pixel = SNK_DRM_Format_bytesPerPixel(format);
+
+    SNK_Font font = {
+        ._format      = format,
+        ._cell_width  = (SNK_FONT_GLYPH_WIDTH + _SNK_FONT_SPACING) * scale,
+        ._cell_height = SNK_FONT_GLYPH_HEIGHT * scale,
+    };
+
+    const size_t cell_stride = font._cell_width * bytes_per_pixel;
+    const size_t cell_size   = cell_stride * font._cell_height;
+
+    font._atlas = SNK_Vec_new(cell_size * _SNK_FONT_GLYPH_COUNT, sizeof(uint8_t), true);
+
+    for (size_t glyph = 0; glyph < _SNK_FONT_GLYPH_COUNT; glyph++) {
+        const auto cell = (uint8_t*)SNK_Vec_data(&font._atlas) + glyph * cell_size;
+
+        for (size_t y = 0; y < font._cell_height; y++) {
+            // Leftmost column in the top bit
+            const uint8_t bits = (uint8_t)(_SNK_FONT_GLYPHS[glyph][y / scale] << (8 - SNK_FONT_GLYPH_WIDTH));
+            uint8_t*      row  = cell + y * cell_stride;
+
+            for (size_t x = 0; x < font._cell_width; x++) {
+                const size_t column = x / scale;
+                const bool   is_set = column < SNK_FONT_GLYPH_WIDTH && (bits & (0x80 >> column));
+
+                const uint32_t pixel = is_set ? foreground : background;
+
+                if (bytes_per_pixel == 2)
+                    ((uint16_t*)row)[x] = (uint16_t)pixel;
+                else
+                    ((uint32_t*)row)[x] = pixel;
+            }
+        }
+    }
+
+    return font;
+}
+
+void SNK_Font_free(SNK_Font* font) {
+    ASSERT(font != nullptr);
+
+    SNK_Vec_free(&font->_atlas);
+
+    *font = (SNK_Font){};
+}
+
+SNK_DRM_Format SNK_Font_format(const SNK_Font* font) {
+    ASSERT(font != nullptr);
+
+    return font->_format;
+}
+
+size_t SNK_Font_lineHeight(const SNK_Font* font) {
+    ASSERT(font != nullptr);
+
+    return font->_cell_height;
+}
+
+size_t SNK_Font_textWidth(const SNK_Font* font, const char* text) {
+    ASSERT(font != nullptr);
+    ASSERT(text != nullptr);
+
+    return strlen(text) * font->_cell_width;
+}
+
+size_t SNK_Font_drawText(const SNK_Font* font, const SNK_DRM_FBInfo fbInfo, const size_t x, const size_t y,
+                         const char* text) {
+    ASSERT(font != nullptr);
+    ASSERT(text != nullptr);
+    ASSERT(font->_format == fbInfo.format);
+
+    if (x >= fbInfo.width || y >= fbInfo.height)
+        return 0;
+
+    const size_t bytes_per_pixel = SNK_DRM_Format_bytesPerPixel(fbInfo.format);
+    const size_t cell_stride     = font->_cell_width * bytes_per_pixel;
+    const size_t cell_size       = cell_stride * font->_cell_height;
+
+    const size_t height = y + font->_cell_height <= fbInfo.height ? font->_cell_height : fbInfo.height - y;
+
+    size_t cursor = x;
+
+    for (const char* c = text; *c != '\0' && cursor < fbInfo.width; c++) {
+        const auto   cell  = (const uint8_t*)SNK_Vec_data(&font->_atlas) + _SNK_Font_glyphIndex(*c) * cell_size;
+        const size_t width = cursor + font->_cell_width <= fbInfo.width ? font->_cell_width : fbInfo.width - cursor;
+
+        for (size_t row = 0; row < height; row++) {
+            const auto dst = (uint8_t*)fbInfo.shadow + (y + row) * fbInfo.stride + cursor * bytes_per_pixel;
+
+            SNK_Blit_copy(dst, cell + row * cell_stride, width * bytes_per_pixel);
+        }
+
+        cursor += width;
+    }
+
+    return cursor - x;
+}
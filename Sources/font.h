@@ -0,0 +1,34 @@
+#pragma once
+
+#include "drm.h"
+#include "vec.h"
+#include <stdint.h>
+
+// Size of a glyph of the built-in font before scaling, in pixels
+static constexpr size_t SNK_FONT_GLYPH_WIDTH  = 5;
+static constexpr size_t SNK_FONT_GLYPH_HEIGHT = 7;
+
+// The built-in font rasterized once into a glyph atlas for one pixel format, scale and pair of colors.
+// Covers printable ASCII up to '_', lowercase letters are drawn as uppercase and anything else as '?'.
+typedef struct {
+    // Every glyph one after another, each a cell of `_cell_width` x `_cell_height` pixels including the spacing
+    SNK_Vec        _atlas;
+    SNK_DRM_Format _format;
+    size_t         _cell_width;
+    size_t         _cell_height;
+} SNK_Font;
+
+// `foreground` and `background` are packed in `format`, glyphs are opaque and scaled by `scale` in both directions
+SNK_Font SNK_Font_new(SNK_DRM_Format format, size_t scale, uint32_t foreground, uint32_t background);
+
+void SNK_Font_free(SNK_Font* font);
+
+SNK_DRM_Format SNK_Font_format(const SNK_Font* font);
+
+size_t SNK_Font_lineHeight(const SNK_Font* font);
+
+size_t SNK_Font_textWidth(const SNK_Font* font, const char* text);
+
+// Draws a line of text into the shadow buffer with its top left corner at x, y, clipped to the framebuffer.
+// Returns the width of the text that was drawn.
+size_t SNK_Font_drawText(const SNK_Font* font, SNK_DRM_FBInfo fbInfo, size_t x, size_t y, const char* text);
@@ -0,0 +1,231 @@
+#include "game.h"
+#include "utils.h"
+#include <stdio.h>
+
+SNK_IVec2 SNK_IVec2_mult(const SNK_IVec2 a, const SNK_IVec2 b) { return (SNK_IVec2){a.x * b.x, a.y * b.y}; }
+
+bool SNK_IVec2_eq(const SNK_IVec2 a, const SNK_IVec2 b) { return a.x == b.x && a.y == b.y; }
+
+SNK_IVec2 SNK_Direction_move(const SNK_IVec2 pos, const SNK_Direction direction) {
+    switch (direction) {
+    case SNK_Direction_Up:
+        return (SNK_IVec2){pos.x, pos.y - 1};
+    case SNK_Direction_Down:
+        return (SNK_IVec2){pos.x, pos.y + 1};
+    case SNK_Direction_Left:
+        return (SNK_IVec2){pos.x - 1, pos.y};
+    case SNK_Direction_Right:
+        return (SNK_IVec2){pos.x + 1, pos.y};
+    default:
+        ASSERT(false);
+    }
+}
+
+SNK_GameInput SNK_GameInput_fromDirection(const SNK_Direction direction) {
+    switch (direction) {
+    case SNK_Direction_Up:
+        return SNK_GameInput_Up;
+    case SNK_Direction_Down:
+        return SNK_GameInput_Down;
+    case SNK_Direction_Left:
+        return SNK_GameInput_Left;
+    case SNK_Direction_Right:
+        return SNK_GameInput_Right;
+    default:
+        ASSERT(false);
+    }
+}
+
+SNK_IVec2 _SNK_Game_wrapPos(const SNK_Game* game, const SNK_IVec2 pos) {
+    return (SNK_IVec2){SNK_wrap(pos.x, 0, game->grid.x), SNK_wrap(pos.y, 0, game->grid.y)};
+}
+
+size_t SNK_Game_cellIndex(const SNK_Game* game, const SNK_IVec2 pos) {
+    ASSERT(game != nullptr);
+    ASSERT(pos.x >= 0 && pos.x < game->grid.x);
+    ASSERT(pos.y >= 0 && pos.y < game->grid.y);
+
+    return (size_t)(pos.y * game->grid.x + pos.x);
+}
+
+bool SNK_Game_isOccupied(const SNK_Game* game, const SNK_IVec2 pos) {
+    ASSERT(game != nullptr);
+
+    return SNK_Bitmap_test(&game->occupancy, SNK_Game_cellIndex(game, _SNK_Game_wrapPos(game, pos)));
+}
+
+void _SNK_Game_markChanged(SNK_Game* game, const size_t cell) {
+    if (game->changes_overflowed)
+        return;
+
+    if (SNK_Vec_size(&game->changed_cells) == SNK_GAME_MAX_CHANGES) {
+        game->changes_overflowed = true;
+
+        return;
+    }
+
+    SNK_Vec_push(&game->changed_cells, &cell, sizeof(size_t));
+}
+
+void _SNK_Game_occupy(SNK_Game* game, const SNK_IVec2 pos) {
+    const size_t cell = SNK_Game_cellIndex(game, pos);
+
+    _SNK_Game_markChanged(game, cell);
+
+    SNK_Bitmap_set(&game->occupancy, cell);
+    SNK_CellSet_remove(&game->free_cells, cell);
+}
+
+void _SNK_Game_vacate(SNK_Game* game, const SNK_IVec2 pos) {
+    const size_t cell = SNK_Game_cellIndex(game, pos);
+
+    _SNK_Game_markChanged(game, cell);
+
+    SNK_Bitmap_clear(&game->occupancy, cell);
+    SNK_CellSet_insert(&game->free_cells, cell);
+}
+
+void _SNK_Game_spawnFood(SNK_Game* game) {
+    const size_t free_count = SNK_CellSet_size(&game->free_cells);
+
+    ASSERT(free_count != 0);
+
+    const size_t cell = SNK_CellSet_at(&game->free_cells, SNK_Rand_range(&game->rand, 0, free_count));
+
+    game->food = (SNK_IVec2){(int64_t)cell % game->grid.x, (int64_t)cell / game->grid.x};
+
+    _SNK_Game_markChanged(game, cell);
+}
+
+SNK_Game SNK_Game_new(const SNK_IVec2 grid, const uint64_t seed) {
+    ASSERT(grid.x > 0 && grid.y > 0);
+
+    SNK_Game game = {
+        .status        = SNK_GameStatus_Running,
+        .grid          = grid,
+        .direction     = SNK_Direction_Right,
+        .move_speed    = 1.0f,
+        .snake_head    = {grid.x / 2, grid.y / 2},
+        .snake_body    = SNK_Ring_new(64, sizeof(SNK_IVec2)),
+        .occupancy     = SNK_Bitmap_new((size_t)(grid.x * grid.y)),
+        .free_cells    = SNK_CellSet_new((size_t)(grid.x * grid.y), true),
+        .rand          = SNK_Rand_new(seed),
+        .changed_cells = SNK_Vec_new(SNK_GAME_MAX_CHANGES, sizeof(size_t), false),
+    };
+
+    _SNK_Game_occupy(&game, game.snake_head);
+    _SNK_Game_spawnFood(&game);
+
+    return game;
+}
+
+void SNK_Game_clearChanges(SNK_Game* game) {
+    ASSERT(game != nullptr);
+
+    SNK_Vec_clear(&game->changed_cells);
+    game->changes_overflowed = false;
+}
+
+bool SNK_Game_isOver(const SNK_Game* game) {
+    ASSERT(game != nullptr);
+
+    return game->status != SNK_GameStatus_Running;
+}
+
+void _SNK_Game_turn(SNK_Game* game, const SNK_Direction direction) {
+    const SNK_IVec2 next = _SNK_Game_wrapPos(game, SNK_Direction_move(game->snake_head, direction));
+
+    // Turning back into the segment right behind the head is ignored
+    if (SNK_Ring_size(&game->snake_body) != 0 && SNK_IVec2_eq(next, *(SNK_IVec2*)SNK_Ring_at(&game->snake_body, 0)))
+        return;
+
+    game->direction = direction;
+}
+
+void SNK_Game_tick(SNK_Game* game, const SNK_GameInput input, const float delta_time) {
+    ASSERT(game != nullptr);
+
+    if (SNK_Game_isOver(game))
+        return;
+
+    if (input & SNK_GameInput_Pause) {
+        game->is_paused = !game->is_paused;
+
+        return;
+    }
+
+    if (input & SNK_GameInput_Quit) {
+        game->status = SNK_GameStatus_Quit;
+
+        return;
+    }
+
+    if (input & SNK_GameInput_Up)
+        _SNK_Game_turn(game, SNK_Direction_Up);
+    else if (input & SNK_GameInput_Down)
+        _SNK_Game_turn(game, SNK_Direction_Down);
+    else if (input & SNK_GameInput_Left)
+        _SNK_Game_turn(game, SNK_Direction_Left);
+    else if (input & SNK_GameInput_Right)
+        _SNK_Game_turn(game, SNK_Direction_Right);
+
+    if (game->is_paused)
+        return;
+
+    if (input & SNK_GameInput_Boost)
+        game->move_progress += game->move_speed * 2.0f * delta_time;
+    else
+        game->move_progress += game->move_speed * delta_time;
+
+    if (game->move_progress >= 1.0f) {
+        const SNK_IVec2 prev_head = game->snake_head;
+
+        game->move_progress = 0.0f;
+        game->snake_head    = _SNK_Game_wrapPos(game, SNK_Direction_move(game->snake_head, game->direction));
+
+        if (SNK_Game_isOccupied(game, game->snake_head)) {
+            game->status = SNK_GameStatus_Lost;
+
+            return;
+        }
+
+        SNK_Ring_pushFront(&game->snake_body, &prev_head, sizeof(SNK_IVec2));
+        // The old head is drawn as body from now on
+        _SNK_Game_markChanged(game, SNK_Game_cellIndex(game, prev_head));
+
+        if (game->pending_growth != 0) {
+            game->pending_growth--;
+        } else {
+            SNK_IVec2 tail;
+
+            SNK_Ring_popBack(&game->snake_body, &tail);
+            _SNK_Game_vacate(game, tail);
+        }
+
+        _SNK_Game_occupy(game, game->snake_head);
+    }
+
+    if (SNK_IVec2_eq(game->snake_head, game->food)) {
+        game->score++;
+        game->move_speed += 0.05f;
+
+        game->pending_growth++;
+
+        if (SNK_Ring_size(&game->snake_body) + game->pending_growth + 1 == game->grid.x * game->grid.y) {
+            game->status = SNK_GameStatus_Won;
+
+            return;
+        }
+
+        _SNK_Game_spawnFood(game);
+    }
+}
+
+void SNK_Game_free(SNK_Game* game) {
+    ASSERT(game != nullptr);
+
+    SNK_Vec_free(&game->changed_cells);
+    SNK_CellSet_free(&game->free_cells);
+    SNK_Bitmap_free(&game->occupancy);
+    SNK_Ring_free(&game->snake_body);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "bitmap.h"
+#include "cellset.h"
+#include "rand.h"
+#include "vec.h"
+#include <stdint.h>
+
+typedef struct {
+    int64_t x;
+    int64_t y;
+} SNK_IVec2;
+
+SNK_IVec2 SNK_IVec2_mult(SNK_IVec2 a, SNK_IVec2 b);
+
+bool SNK_IVec2_eq(SNK_IVec2 a, SNK_IVec2 b);
+
+typedef enum {
+    SNK_Direction_Up,
+    SNK_Direction_Down,
+    SNK_Direction_Left,
+    SNK_Direction_Right,
+} SNK_Direction;
+
+SNK_IVec2 SNK_Direction_move(SNK_IVec2 pos, SNK_Direction direction);
+
+// Input for one tick, independent of where it came from
+typedef enum {
+    SNK_GameInput_Up    = 1 << 0,
+    SNK_GameInput_Down  = 1 << 1,
+    SNK_GameInput_Left  = 1 << 2,
+    SNK_GameInput_Right = 1 << 3,
+    SNK_GameInput_Boost = 1 << 4,
+    // Edge triggered, set only on the tick the pause key was released
+    SNK_GameInput_Pause = 1 << 5,
+    SNK_GameInput_Quit  = 1 << 6,
+} SNK_GameInputFlag;
+
+typedef uint8_t SNK_GameInput;
+
+SNK_GameInput SNK_GameInput_fromDirection(SNK_Direction direction);
+
+typedef enum {
+    SNK_GameStatus_Running,
+    SNK_GameStatus_Lost,
+    SNK_GameStatus_Won,
+    SNK_GameStatus_Quit,
+} SNK_GameStatus;
+
+typedef struct {
+    bool           is_paused;
+    SNK_GameStatus status;
+    size_t         score;
+    SNK_IVec2      grid;
+    float          move_progress;
+    float          move_speed;
+    SNK_Direction  direction;
+    SNK_IVec2      snake_head;
+    SNK_IVec2      food;
+    // SNK_IVec2, front is the segment right behind the head
+    SNK_Ring snake_body;
+    // Segments still to be added, the tail stays in place while this is non-zero
+    size_t pending_growth;
+    // One bit per grid cell, set for the head and every body segment
+    SNK_Bitmap occupancy;
+    // Every cell not covered by the snake, food is picked from here
+    SNK_CellSet free_cells;
+    SNK_Rand    rand;
+    // size_t, cells whose content changed since the last SNK_Game_clearChanges
+    SNK_Vec changed_cells;
+    // Set instead of listing more than SNK_GAME_MAX_CHANGES cells, the whole grid should be considered changed
+    bool changes_overflowed;
+} SNK_Game;
+
+static constexpr float SNK_DELTA_TIME = 0.033f;
+
+static constexpr size_t SNK_GAME_MAX_CHANGES = 64;
+
+SNK_Game SNK_Game_new(SNK_IVec2 grid, uint64_t seed);
+
+bool SNK_Game_isOver(const SNK_Game* game);
+
+size_t SNK_Game_cellIndex(const SNK_Game* game, SNK_IVec2 pos);
+
+bool SNK_Game_isOccupied(const SNK_Game* game, SNK_IVec2 pos);
+
+void SNK_Game_clearChanges(SNK_Game* game);
+
+void SNK_Game_tick(SNK_Game* game, SNK_GameInput input, float delta_time);
+
+void SNK_Game_free(SNK_Game* game);
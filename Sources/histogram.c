@@ -0,0 +1,100 @@
+#include "histogram.h"
+#include "utils.h"
+#include <stdio.h>
+
+constexpr uint64_t _SNK_HISTOGRAM_SUB_COUNT = 1 << SNK_HISTOGRAM_SUB_BITS;
+
+size_t _SNK_Histogram_bucket(const uint64_t value) {
+    if (value < _SNK_HISTOGRAM_SUB_COUNT)
+        return (size_t)value;
+
+    const int exponent = 63 - __builtin_clzll(value);
+    const int shift    = exponent - SNK_HISTOGRAM_SUB_BITS;
+
+    return (size_t)(shift + 1) * _SNK_HISTOGRAM_SUB_COUNT + ((value >> shift) & (_SNK_HISTOGRAM_SUB_COUNT - 1));
+}
+
+uint64_t _SNK_Histogram_bucketMax(const size_t bucket) {
+    if (bucket < _SNK_HISTOGRAM_SUB_COUNT)
+        return bucket;
+
+    const int      shift = (int)(bucket / _SNK_HISTOGRAM_SUB_COUNT) - 1;
+    const uint64_t low   = (_SNK_HISTOGRAM_SUB_COUNT + bucket % _SNK_HISTOGRAM_SUB_COUNT) << shift;
+
+    return low + (((uint64_t)1 << shift) - 1);
+}
+
+void SNK_Histogram_reset(SNK_Histogram* histogram) {
+    ASSERT(histogram != nullptr);
+
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->_min = UINT64_MAX;
+}
+
+void SNK_Histogram_record(SNK_Histogram* histogram, const uint64_t value) {
+    ASSERT(histogram != nullptr);
+
+    histogram->_counts[_SNK_Histogram_bucket(value)]++;
+    histogram->_count++;
+    histogram->_sum += value;
+
+    if (value < histogram->_min)
+        histogram->_min = value;
+
+    if (value > histogram->_max)
+        histogram->_max = value;
+}
+
+uint64_t SNK_Histogram_count(const SNK_Histogram* histogram) {
+    ASSERT(histogram != nullptr);
+
+    return histogram->_count;
+}
+
+uint64_t SNK_Histogram_sum(const SNK_Histogram* histogram) {
+    ASSERT(histogram != nullptr);
+
+    return histogram->_sum;
+}
+
+uint64_t SNK_Histogram_min(const SNK_Histogram* histogram) {
+    ASSERT(histogram != nullptr);
+
+    return histogram->_count != 0 ? histogram->_min : 0;
+}
+
+uint64_t SNK_Histogram_max(const SNK_Histogram* histogram) {
+    ASSERT(histogram != nullptr);
+
+    return histogram->_max;
+}
+
+uint64_t SNK_Histogram_mean(const SNK_Histogram* histogram) {
+    ASSERT(histogram != nullptr);
+
+    return histogram->_count != 0 ? histogram->_sum / histogram->_count : 0;
+}
+
+uint64_t SNK_Histogram_percentile(const SNK_Histogram* histogram, const uint32_t per_mille) {
+    ASSERT(histogram != nullptr);
+    ASSERT(per_mille <= 1000);
+
+    if (histogram->_count == 0)
+        return 0;
+
+    // Rank of the requested sample, rounded up so that p1000 is the last one
+    const uint64_t rank = (histogram->_count * per_mille + 999) / 1000;
+    uint64_t       seen = 0;
+
+    for (size_t i = 0; i < SNK_HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->_counts[i];
+
+        if (seen >= rank && seen != 0) {
+            const uint64_t value = _SNK_Histogram_bucketMax(i);
+
+            return value > histogram->_max ? histogram->_max : value;
+        }
+    }
+
+    return histogram->_max;
+}
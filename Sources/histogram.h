@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+// Log-linear buckets: exact below 16, then 16 buckets per power of two (at most ~6% relative error)
+#define SNK_HISTOGRAM_SUB_BITS 4
+#define SNK_HISTOGRAM_BUCKETS  ((64 - SNK_HISTOGRAM_SUB_BITS + 1) << SNK_HISTOGRAM_SUB_BITS)
+
+// Fixed-size value histogram, recording never allocates
+typedef struct {
+    uint64_t _counts[SNK_HISTOGRAM_BUCKETS];
+    uint64_t _count;
+    uint64_t _sum;
+    uint64_t _min;
+    uint64_t _max;
+} SNK_Histogram;
+
+void SNK_Histogram_reset(SNK_Histogram* histogram);
+
+void SNK_Histogram_record(SNK_Histogram* histogram, uint64_t value);
+
+uint64_t SNK_Histogram_count(const SNK_Histogram* histogram);
+
+uint64_t SNK_Histogram_sum(const SNK_Histogram* histogram);
+
+uint64_t SNK_Histogram_min(const SNK_Histogram* histogram);
+
+uint64_t SNK_Histogram_max(const SNK_Histogram* histogram);
+
+uint64_t SNK_Histogram_mean(const SNK_Histogram* histogram);
+
+uint64_t SNK_Histogram_percentile(const SNK_Histogram* histogram, uint32_t per_mille);
@@ -77,44 +77,66 @@ bool SNK_InputDevice_open(SNK_InputDevice* device, const char* path) {
     ASSERT(device != nullptr);
     ASSERT(path != nullptr);
 
-    const int fd = open(path, O_RDONLY);
+    const int fd = open(path, O_RDONLY | O_NONBLOCK);
 
     if (fd < 0)
         return false;
 
-    device->_fd = fd;
+    *device = (SNK_InputDevice){
+        ._fd = fd,
+    };
 
     return true;
 }
 
-bool SNK_InputDevice_poll(const SNK_InputDevice* device, SNK_InputEvent* ev) {
-    ASSERT(device != nullptr);
-    ASSERT(device->_fd >= 0);
+// Reads as many events as fit after the leftover bytes of a cut off one, returns whether it got any bytes
+bool _SNK_InputDevice_read(SNK_InputDevice* device) {
+    const size_t leftover = device->_size - device->_offset;
 
-    struct timeval tv = {
-        .tv_sec  = 0,
-        .tv_usec = 0,
-    };
+    memmove(device->_buffer, device->_buffer + device->_offset, leftover);
 
-    fd_set read_set;
+    device->_size   = leftover;
+    device->_offset = 0;
 
-    FD_ZERO(&read_set);
-    FD_SET(device->_fd, &read_set);
+    const size_t  space = sizeof(device->_buffer) - leftover;
+    const ssize_t bytes = read(device->_fd, device->_buffer + leftover, space);
 
-    const int ret = select(device->_fd + 1, &read_set, nullptr, nullptr, &tv);
+    if (bytes < 0) {
+        if (errno == EAGAIN || errno == EINTR)
+            return false;
 
-    if (ret < 0)
-        SNK_crash("Failed to poll input device: %s", strerror(errno));
+        SNK_crash("Failed to read input device: %s", strerror(errno));
+    }
 
-    if (ret == 0)
-        return false;
+    ASSERT(bytes != 0);
 
-    const ssize_t bytes = read(device->_fd, ev, sizeof(SNK_InputEvent));
+    device->_size += (size_t)bytes;
+    // A full buffer may have left events behind in the device
+    device->_is_drained = (size_t)bytes < space;
 
-    ASSERT(bytes != 0);
+    return true;
+}
 
-    if (bytes < 0)
-        SNK_crash("Failed to read input device: %s", strerror(errno));
+bool SNK_InputDevice_poll(SNK_InputDevice* device, SNK_InputEvent* ev) {
+    ASSERT(device != nullptr);
+    ASSERT(device->_fd >= 0);
+    ASSERT(ev != nullptr);
+
+    while (device->_size - device->_offset < sizeof(SNK_InputEvent)) {
+        // Reading again would only come back empty, the next poll is the next frame's
+        if (device->_is_drained) {
+            device->_is_drained = false;
+
+            return false;
+        }
+
+        if (!_SNK_InputDevice_read(device))
+            return false;
+    }
+
+    memcpy(ev, device->_buffer + device->_offset, sizeof(SNK_InputEvent));
+
+    device->_offset += sizeof(SNK_InputEvent);
 
     return true;
 }
@@ -150,11 +172,14 @@ bool SNK_Keyboard_isPressed(const SNK_Keyboard* keyboard, const uint16_t key) {
     return keyboard->_keyboard[key];
 }
 
-void SNK_Keyboard_update(SNK_Keyboard* keyboard) {
+void SNK_Keyboard_update(SNK_Keyboard* keyboard, const bool has_events) {
     ASSERT(keyboard != nullptr);
 
     memset(keyboard->_old_keyboard, false, sizeof(keyboard->_old_keyboard));
 
+    if (!has_events)
+        return;
+
     SNK_InputEvent ev = {};
 
     while (SNK_InputDevice_poll(&keyboard->_device, &ev)) {
@@ -170,6 +195,12 @@ void SNK_Keyboard_update(SNK_Keyboard* keyboard) {
     }
 }
 
+int SNK_Keyboard_fd(const SNK_Keyboard* keyboard) {
+    ASSERT(keyboard != nullptr);
+
+    return keyboard->_device._fd;
+}
+
 void SNK_Keyboard_free(SNK_Keyboard* keyboard) {
     ASSERT(keyboard != nullptr);
 
@@ -12,13 +12,25 @@ typedef struct {
 
 void SNK_InputEvent_dump(const SNK_InputEvent* ev);
 
+// Events read from the device per syscall at most
+static constexpr size_t SNK_INPUT_BATCH_SIZE = 64;
+
 typedef struct {
     int _fd;
+    // Events read ahead of the ones handed out, along with the start of an event a read may have cut off
+    uint8_t _buffer[SNK_INPUT_BATCH_SIZE * sizeof(SNK_InputEvent)];
+    size_t  _size;
+    size_t  _offset;
+    // The last read emptied the device's queue, so once the buffer runs out there is nothing left to read
+    bool _is_drained;
 } SNK_InputDevice;
 
+// Opens the device non-blocking, so that polling it never waits for input
 bool SNK_InputDevice_open(SNK_InputDevice* device, const char* path);
 
-bool SNK_InputDevice_poll(const SNK_InputDevice* device, SNK_InputEvent* ev);
+// Returns the next event, reading a batch of them when the buffer runs out. It returns false once everything that
+// was queued has been handed out, after a single read when there was less than a batch.
+bool SNK_InputDevice_poll(SNK_InputDevice* device, SNK_InputEvent* ev);
 
 void SNK_InputDevice_close(SNK_InputDevice* device);
 
@@ -34,6 +46,11 @@ bool SNK_Keyboard_wasPressed(const SNK_Keyboard* keyboard, const uint16_t key);
 
 bool SNK_Keyboard_isPressed(const SNK_Keyboard* keyboard, const uint16_t key);
 
-void SNK_Keyboard_update(SNK_Keyboard* keyboard);
+// Takes in the key events since the last update, which is what SNK_Keyboard_wasPressed reports on. Without
+// `has_events` the device isn't read, for callers that know from an event loop that nothing is queued.
+void SNK_Keyboard_update(SNK_Keyboard* keyboard, bool has_events);
+
+// Input device the keyboard reads, for an event loop to wait on
+int SNK_Keyboard_fd(const SNK_Keyboard* keyboard);
 
 void SNK_Keyboard_free(SNK_Keyboard* keyboard);
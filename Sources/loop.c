@@ -0,0 +1,116 @@
+#include "loop.h"
+#include "utils.h"
+#include <stdio.h>
+
+bool SNK_EventLoop_open(SNK_EventLoop* loop) {
+    ASSERT(loop != nullptr);
+
+    const int fd = (int)syscall(__NR_epoll_create1, EPOLL_CLOEXEC);
+
+    if (fd < 0)
+        return false;
+
+    *loop = (SNK_EventLoop){
+        ._fd = fd,
+    };
+
+    return true;
+}
+
+bool SNK_EventLoop_add(SNK_EventLoop* loop, const int fd, const uint32_t events, const SNK_EventLoop_Handler handler,
+                       void* context) {
+    ASSERT(loop != nullptr);
+    ASSERT(loop->_fd >= 0);
+    ASSERT(fd >= 0);
+    ASSERT(handler != nullptr);
+
+    size_t index = 0;
+
+    while (index < loop->_source_count && loop->_sources[index].handler != nullptr)
+        index++;
+
+    ASSERT(index < SNK_EVENT_LOOP_MAX_SOURCES);
+
+    // The kernel hands back the source's index, not the fd, so a ready fd costs no lookup
+    struct epoll_event event = {
+        .events = events,
+        .data   = index,
+    };
+
+    if (syscall(__NR_epoll_ctl, loop->_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+        return false;
+
+    loop->_sources[index] = (_SNK_EventSource){
+        .fd      = fd,
+        .handler = handler,
+        .context = context,
+    };
+
+    if (index == loop->_source_count)
+        loop->_source_count++;
+
+    return true;
+}
+
+bool SNK_EventLoop_remove(SNK_EventLoop* loop, const int fd) {
+    ASSERT(loop != nullptr);
+    ASSERT(loop->_fd >= 0);
+
+    for (size_t i = 0; i < loop->_source_count; i++) {
+        _SNK_EventSource* source = &loop->_sources[i];
+
+        if (source->handler == nullptr || source->fd != fd)
+            continue;
+
+        if (syscall(__NR_epoll_ctl, loop->_fd, EPOLL_CTL_DEL, fd, nullptr) != 0)
+            return false;
+
+        *source = (_SNK_EventSource){};
+
+        return true;
+    }
+
+    errno = ENOENT;
+
+    return false;
+}
+
+size_t SNK_EventLoop_dispatch(const SNK_EventLoop* loop, const int timeout_ms) {
+    ASSERT(loop != nullptr);
+    ASSERT(loop->_fd >= 0);
+
+    struct epoll_event events[SNK_EVENT_LOOP_MAX_SOURCES];
+
+    // aarch64 only has the pwait variant, no signal mask makes it plain epoll_wait
+    const int count = (int)syscall(__NR_epoll_pwait, loop->_fd, events, (int)ARRSIZE(events), timeout_ms, nullptr, 0);
+
+    if (count < 0) {
+        if (errno == EINTR)
+            return 0;
+
+        SNK_crash("Failed to wait for events: %s", strerror(errno));
+    }
+
+    for (int i = 0; i < count; i++) {
+        const _SNK_EventSource* source = &loop->_sources[events[i].data];
+
+        // Removed by the handler of an earlier event in the same batch
+        if (source->handler == nullptr)
+            continue;
+
+        source->handler(source->context, events[i].events);
+    }
+
+    return (size_t)count;
+}
+
+void SNK_EventLoop_close(SNK_EventLoop* loop) {
+    ASSERT(loop != nullptr);
+
+    if (loop->_fd >= 0)
+        close(loop->_fd);
+
+    *loop = (SNK_EventLoop){
+        ._fd = -1,
+    };
+}
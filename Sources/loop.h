@@ -0,0 +1,40 @@
+#pragma once
+
+#include <linux/eventpoll.h>
+#include <stdint.h>
+
+// Most file descriptors one loop watches
+static constexpr size_t SNK_EVENT_LOOP_MAX_SOURCES = 8;
+
+// Called with the epoll events of a source that became ready, such as EPOLLIN
+typedef void (*SNK_EventLoop_Handler)(void* context, uint32_t events);
+
+// A slot without a handler is free for the next source
+typedef struct {
+    int                   fd;
+    SNK_EventLoop_Handler handler;
+    void*                 context;
+} _SNK_EventSource;
+
+// Waits on any number of file descriptors at once with epoll, and runs the handler of each one that is ready
+typedef struct {
+    int              _fd;
+    _SNK_EventSource _sources[SNK_EVENT_LOOP_MAX_SOURCES];
+    size_t           _source_count;
+} SNK_EventLoop;
+
+bool SNK_EventLoop_open(SNK_EventLoop* loop);
+
+// Runs `handler` whenever `fd` has any of the epoll `events`, such as EPOLLIN, or only when it gets new ones with
+// EPOLLET. The loop only watches the fd, it stays the caller's to read and close.
+bool SNK_EventLoop_add(SNK_EventLoop* loop, int fd, uint32_t events, SNK_EventLoop_Handler handler, void* context);
+
+// Stops watching `fd`. epoll keys a source by the open file, so an fd that is about to be pointed at another file with
+// dup2 has to be removed before and added again after.
+bool SNK_EventLoop_remove(SNK_EventLoop* loop, int fd);
+
+// Waits up to `timeout_ms` for sources to become ready, -1 for as long as it takes and 0 not at all.
+// Returns how many handlers it ran.
+size_t SNK_EventLoop_dispatch(const SNK_EventLoop* loop, int timeout_ms);
+
+void SNK_EventLoop_close(SNK_EventLoop* loop);
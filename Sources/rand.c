@@ -0,0 +1,69 @@
+#include "rand.h"
+#include "utils.h"
+#include <stdio.h>
+
+uint64_t _SNK_Rand_rotl(const uint64_t x, const int k) { return (x << k) | (x >> (64 - k)); }
+
+uint64_t _SNK_Rand_splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+
+    return z ^ (z >> 31);
+}
+
+SNK_Rand SNK_Rand_new(uint64_t seed) {
+    SNK_Rand rand = {};
+
+    // Expand the seed with splitmix64 so that similar seeds still give unrelated, non-zero states
+    for (size_t i = 0; i < ARRSIZE(rand._state); i++)
+        rand._state[i] = _SNK_Rand_splitmix64(&seed);
+
+    return rand;
+}
+
+uint64_t SNK_Rand_kernelSeed() {
+    uint64_t seed = 0;
+
+    if (syscall(__NR_getrandom, &seed, sizeof(seed), 0) == sizeof(seed))
+        return seed;
+
+    const int fd = open("/dev/urandom", O_RDONLY);
+
+    if (fd == -1)
+        SNK_crash("Failed to open /dev/urandom: %s", strerror(errno));
+
+    if (read(fd, &seed, sizeof(seed)) != sizeof(seed))
+        SNK_crash("Failed to read from /dev/urandom: %s", strerror(errno));
+
+    close(fd);
+
+    return seed;
+}
+
+uint64_t SNK_Rand_next(SNK_Rand* rand) {
+    ASSERT(rand != nullptr);
+
+    uint64_t* s = rand->_state;
+
+    const uint64_t result = _SNK_Rand_rotl(s[1] * 5, 7) * 9;
+    const uint64_t t      = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+
+    s[2] ^= t;
+    s[3] = _SNK_Rand_rotl(s[3], 45);
+
+    return result;
+}
+
+uint64_t SNK_Rand_range(SNK_Rand* rand, const uint64_t min, const uint64_t max) {
+    ASSERT(min < max);
+
+    // Multiply-shift maps the full 64-bit output onto the range without a division
+    return min + SNK_mulHigh64(SNK_Rand_next(rand), max - min);
+}
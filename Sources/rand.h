@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+// xoshiro256** generator, seeded once and then advanced without syscalls
+typedef struct {
+    uint64_t _state[4];
+} SNK_Rand;
+
+SNK_Rand SNK_Rand_new(uint64_t seed);
+
+uint64_t SNK_Rand_kernelSeed();
+
+uint64_t SNK_Rand_next(SNK_Rand* rand);
+
+uint64_t SNK_Rand_range(SNK_Rand* rand, uint64_t min, uint64_t max);
@@ -0,0 +1,190 @@
+#include "record.h"
+#include "utils.h"
+#include <stdio.h>
+
+#define _SNK_RECORD_MAGIC   "SNKR"
+#define _SNK_RECORD_VERSION 1
+
+// Inputs are written out once this many ticks have been buffered
+constexpr size_t _SNK_RECORD_FLUSH_SIZE = 4096;
+
+typedef struct {
+    char     magic[4];
+    uint32_t version;
+    uint64_t seed;
+    int64_t  grid_x;
+    int64_t  grid_y;
+    float    delta_time;
+    uint32_t reserved;
+} _SNK_RecordFileHeader;
+
+// The magic and version say whose file it is, the rest is checked since a replay feeds it straight into the game
+bool _SNK_RecordFileHeader_isValid(const _SNK_RecordFileHeader* header) {
+    if (memcmp(header->magic, _SNK_RECORD_MAGIC, sizeof(header->magic)) != 0 || header->version != _SNK_RECORD_VERSION)
+        return false;
+
+    // Every cell needs a 32 bit index, checked by division so huge sides can't overflow the product
+    if (header->grid_x < 2 || header->grid_y < 2 || (uint64_t)header->grid_x > UINT32_MAX / (uint64_t)header->grid_y)
+        return false;
+
+    return __builtin_isfinite(header->delta_time) && header->delta_time > 0.0f;
+}
+
+bool _SNK_Recorder_flush(SNK_Recorder* recorder) {
+    const size_t size = SNK_Vec_size(&recorder->_buffer);
+
+    if (size == 0)
+        return true;
+
+    const bool is_written = write(recorder->_fd, SNK_Vec_data(&recorder->_buffer), size) == (ssize_t)size;
+
+    SNK_Vec_clear(&recorder->_buffer);
+
+    return is_written;
+}
+
+bool SNK_Recorder_open(SNK_Recorder* recorder, const char* path, const SNK_RecordHeader* header) {
+    ASSERT(recorder != nullptr);
+    ASSERT(path != nullptr);
+    ASSERT(header != nullptr);
+
+    const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0)
+        return false;
+
+    _SNK_RecordFileHeader file_header = {
+        .magic      = _SNK_RECORD_MAGIC,
+        .version    = _SNK_RECORD_VERSION,
+        .seed       = header->seed,
+        .grid_x     = header->grid.x,
+        .grid_y     = header->grid.y,
+        .delta_time = header->delta_time,
+    };
+
+    if (write(fd, &file_header, sizeof(file_header)) != sizeof(file_header)) {
+        close(fd);
+
+        return false;
+    }
+
+    recorder->_fd     = fd;
+    recorder->_buffer = SNK_Vec_new(_SNK_RECORD_FLUSH_SIZE, sizeof(uint8_t), false);
+
+    return true;
+}
+
+void SNK_Recorder_push(SNK_Recorder* recorder, const SNK_GameInput input) {
+    ASSERT(recorder != nullptr);
+    ASSERT(recorder->_fd >= 0);
+
+    SNK_Vec_push(&recorder->_buffer, &input, sizeof(uint8_t));
+
+    if (SNK_Vec_size(&recorder->_buffer) >= _SNK_RECORD_FLUSH_SIZE && !_SNK_Recorder_flush(recorder))
+        SNK_crash("Failed to write recording: %s", strerror(errno));
+}
+
+bool SNK_Recorder_close(SNK_Recorder* recorder) {
+    ASSERT(recorder != nullptr);
+    ASSERT(recorder->_fd >= 0);
+
+    bool is_ok = _SNK_Recorder_flush(recorder);
+
+    if (close(recorder->_fd) != 0)
+        is_ok = false;
+
+    SNK_Vec_free(&recorder->_buffer);
+    recorder->_fd = -1;
+
+    return is_ok;
+}
+
+bool SNK_Replay_open(SNK_Replay* replay, const char* path) {
+    ASSERT(replay != nullptr);
+    ASSERT(path != nullptr);
+
+    const int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+        return false;
+
+    const off_t file_size = lseek(fd, 0, SEEK_END);
+
+    if (file_size < (off_t)sizeof(_SNK_RecordFileHeader) || lseek(fd, 0, SEEK_SET) != 0) {
+        close(fd);
+        errno = EINVAL;
+
+        return false;
+    }
+
+    _SNK_RecordFileHeader file_header;
+
+    if (read(fd, &file_header, sizeof(file_header)) != sizeof(file_header) ||
+        !_SNK_RecordFileHeader_isValid(&file_header)) {
+        close(fd);
+        errno = EINVAL;
+
+        return false;
+    }
+
+    const size_t input_count = (size_t)file_size - sizeof(file_header);
+
+    *replay = (SNK_Replay){
+        .header =
+            {
+                .seed       = file_header.seed,
+                .grid       = {file_header.grid_x, file_header.grid_y},
+                .delta_time = file_header.delta_time,
+            },
+        ._inputs   = SNK_Vec_new(input_count, sizeof(uint8_t), true),
+        ._position = 0,
+    };
+
+    size_t offset = 0;
+
+    while (offset < input_count) {
+        const ssize_t bytes = read(fd, (uint8_t*)SNK_Vec_data(&replay->_inputs) + offset, input_count - offset);
+
+        if (bytes <= 0) {
+            close(fd);
+            SNK_Replay_free(replay);
+
+            if (bytes == 0)
+                errno = EINVAL;
+
+            return false;
+        }
+
+        offset += (size_t)bytes;
+    }
+
+    close(fd);
+
+    return true;
+}
+
+bool SNK_Replay_next(SNK_Replay* replay, SNK_GameInput* input) {
+    ASSERT(replay != nullptr);
+    ASSERT(input != nullptr);
+
+    if (replay->_position >= SNK_Vec_size(&replay->_inputs))
+        return false;
+
+    *input = *(uint8_t*)SNK_Vec_at(&replay->_inputs, replay->_position);
+    replay->_position++;
+
+    return true;
+}
+
+size_t SNK_Replay_size(const SNK_Replay* replay) {
+    ASSERT(replay != nullptr);
+
+    return SNK_Vec_size(&replay->_inputs);
+}
+
+void SNK_Replay_free(SNK_Replay* replay) {
+    ASSERT(replay != nullptr);
+
+    SNK_Vec_free(&replay->_inputs);
+    replay->_position = 0;
+}
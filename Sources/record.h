@@ -0,0 +1,40 @@
+#pragma once
+
+#include "game.h"
+#include "vec.h"
+#include <stdint.h>
+
+// Everything besides the inputs that a game needs to play out the same way again
+typedef struct {
+    uint64_t  seed;
+    SNK_IVec2 grid;
+    float     delta_time;
+} SNK_RecordHeader;
+
+// Writes a header followed by one SNK_GameInput byte per tick, in host byte order
+typedef struct {
+    int _fd;
+    // uint8_t
+    SNK_Vec _buffer;
+} SNK_Recorder;
+
+bool SNK_Recorder_open(SNK_Recorder* recorder, const char* path, const SNK_RecordHeader* header);
+
+void SNK_Recorder_push(SNK_Recorder* recorder, SNK_GameInput input);
+
+bool SNK_Recorder_close(SNK_Recorder* recorder);
+
+typedef struct {
+    SNK_RecordHeader header;
+    // uint8_t
+    SNK_Vec _inputs;
+    size_t  _position;
+} SNK_Replay;
+
+bool SNK_Replay_open(SNK_Replay* replay, const char* path);
+
+bool SNK_Replay_next(SNK_Replay* replay, SNK_GameInput* input);
+
+size_t SNK_Replay_size(const SNK_Replay* replay);
+
+void SNK_Replay_free(SNK_Replay* replay);
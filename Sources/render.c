@@ -0,0 +1,588 @@
+#include "render.h"
+#include "blit.h"
+#include "utils.h"
+#include <stdio.h>
+
+// Least a band should hold before handing it to another core beats doing it in place
+constexpr size_t _SNK_RENDERER_MIN_BAND_SIZE = 128 * 1024;
+// Bands per thread, so a core that gets descheduled holds up less of the frame
+constexpr size_t _SNK_RENDERER_BANDS_PER_THREAD = 2;
+
+constexpr size_t _SNK_RENDERER_HUD_FONT_SCALE = 3;
+constexpr size_t _SNK_RENDERER_HUD_MARGIN     = 8;
+
+// Sprites in the order they are asked for, the head moves every step so it gets the first plane
+constexpr size_t _SNK_RENDERER_HEAD_SPRITE = 0;
+constexpr size_t _SNK_RENDERER_FOOD_SPRITE = 1;
+
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} _SNK_RGB;
+
+const _SNK_RGB SNK_SNAKE_HEAD_COLOR = {2, 181, 38};
+const _SNK_RGB SNK_SNAKE_BODY_COLOR = {38, 126, 5};
+const _SNK_RGB SNAKE_FOOD_COLOR     = {240, 255, 0};
+const _SNK_RGB SNK_BACKGROUND_COLOR = {0, 0, 0};
+const _SNK_RGB SNK_HUD_TEXT_COLOR   = {230, 230, 230};
+
+// Everything a cell can look like, each one is rasterized into a tile once
+typedef enum {
+    _SNK_Tile_Background,
+    _SNK_Tile_Head,
+    _SNK_Tile_Body,
+    _SNK_Tile_Food,
+    _SNK_Tile_Count,
+} _SNK_Tile;
+
+uint32_t _SNK_RGB_pack(const _SNK_RGB color, const SNK_DRM_Format format) {
+    switch (format) {
+    case SNK_DRM_Format_XRGB8888:
+        return (color.r << 16) | (color.g << 8) | color.b;
+    case SNK_DRM_Format_RGB565:
+        return ((color.r >> 3) << 11) | ((color.g >> 2) << 5) | (color.b >> 3);
+    case SNK_DRM_Format_ARGB8888:
+        return 0xFF000000 | (color.r << 16) | (color.g << 8) | color.b;
+    }
+
+    SNK_crash("Unknown pixel format %d", format);
+}
+
+void _SNK_fillSpan(void* dst, const uint32_t pixel, const size_t count, const SNK_DRM_Format format) {
+    if (SNK_DRM_Format_bytesPerPixel(format) == 2)
+        SNK_Blit_fill16(dst, (uint16_t)pixel, count);
+    else
+        SNK_Blit_fill32(dst, pixel, count);
+}
+
+// Fills a rect that lies entirely inside the framebuffer, one horizontal span per row
+void _SNK_fillRect(const size_t x, const size_t y, const size_t width, const size_t height, const uint32_t pixel,
+                   const SNK_DRM_FBInfo fbInfo) {
+    const size_t x_offset = x * SNK_DRM_Format_bytesPerPixel(fbInfo.format);
+
+    for (size_t row = y; row < y + height; row++)
+        _SNK_fillSpan((uint8_t*)fbInfo.shadow + row * fbInfo.stride + x_offset, pixel, width, fbInfo.format);
+}
+
+// Part of a rect that wrapped around the framebuffer edge, with its offset inside the original rect
+typedef struct {
+    size_t x;
+    size_t y;
+    size_t width;
+    size_t height;
+    size_t offset_x;
+    size_t offset_y;
+} _SNK_WrappedRect;
+
+// Splits a rect that may run off the right or bottom edge into at most four in-bounds rects, returns how many
+size_t _SNK_wrapRect(const SNK_IVec2 pos, const SNK_IVec2 size, const SNK_DRM_FBInfo fbInfo,
+                     _SNK_WrappedRect parts[4]) {
+    const size_t x      = SNK_wrap(pos.x, 0, (int64_t)fbInfo.width);
+    const size_t y      = SNK_wrap(pos.y, 0, (int64_t)fbInfo.height);
+    const size_t width  = (size_t)size.x < fbInfo.width ? (size_t)size.x : fbInfo.width;
+    const size_t height = (size_t)size.y < fbInfo.height ? (size_t)size.y : fbInfo.height;
+
+    const size_t left_width    = x + width <= fbInfo.width ? width : fbInfo.width - x;
+    const size_t top_height    = y + height <= fbInfo.height ? height : fbInfo.height - y;
+    const size_t right_width   = width - left_width;
+    const size_t bottom_height = height - top_height;
+
+    const _SNK_WrappedRect candidates[4] = {
+        {x, y, left_width, top_height, 0, 0},
+        {0, y, right_width, top_height, left_width, 0},
+        {x, 0, left_width, bottom_height, 0, top_height},
+        {0, 0, right_width, bottom_height, left_width, top_height},
+    };
+
+    size_t count = 0;
+
+    for (size_t i = 0; i < ARRSIZE(candidates); i++) {
+        if (candidates[i].width != 0 && candidates[i].height != 0)
+            parts[count++] = candidates[i];
+    }
+
+    return count;
+}
+
+// Draws a rect that may run off the right or bottom edge, wrapping the overhang around to the other side
+void _SNK_drawRect(const SNK_IVec2 pos, const SNK_IVec2 size, const _SNK_RGB color, const SNK_DRM_FBInfo fbInfo) {
+    const uint32_t pixel = _SNK_RGB_pack(color, fbInfo.format);
+
+    _SNK_WrappedRect parts[4];
+    const size_t     part_count = _SNK_wrapRect(pos, size, fbInfo, parts);
+
+    for (size_t i = 0; i < part_count; i++)
+        _SNK_fillRect(parts[i].x, parts[i].y, parts[i].width, parts[i].height, pixel, fbInfo);
+}
+
+SNK_Renderer SNK_Renderer_new(const SNK_IVec2 scale, SNK_WorkerPool* workers) {
+    SNK_Renderer renderer = {
+        ._scale              = scale,
+        ._workers            = workers,
+        ._needs_full_repaint = true,
+        // One more for the HUD
+        ._rects = SNK_Vec_new(SNK_RENDERER_MAX_DAMAGE + 1, sizeof(SNK_DRM_Rect), false),
+    };
+
+    for (size_t i = 0; i < SNK_DRM_MAX_BUFFERS; i++) {
+        renderer._damage[i]           = SNK_Vec_new(SNK_RENDERER_MAX_DAMAGE, sizeof(size_t), false);
+        renderer._needs_full_flush[i] = true;
+    }
+
+    return renderer;
+}
+
+void SNK_Renderer_invalidate(SNK_Renderer* renderer) {
+    ASSERT(renderer != nullptr);
+
+    renderer->_needs_full_repaint = true;
+}
+
+void SNK_Renderer_free(SNK_Renderer* renderer) {
+    ASSERT(renderer != nullptr);
+
+    for (size_t i = 0; i < SNK_DRM_MAX_BUFFERS; i++)
+        SNK_Vec_free(&renderer->_damage[i]);
+
+    SNK_Vec_free(&renderer->_rects);
+    SNK_Vec_free(&renderer->_tiles);
+    SNK_Font_free(&renderer->_font);
+
+    *renderer = (SNK_Renderer){};
+}
+
+// Rasterizes every tile and the HUD font for the pixel format, unless they already are
+void _SNK_Renderer_prepareTiles(SNK_Renderer* renderer, const SNK_DRM_Format format) {
+    if (SNK_Vec_size(&renderer->_tiles) != 0 && renderer->_tile_format == format)
+        return;
+
+    const _SNK_RGB colors[_SNK_Tile_Count] = {
+        [_SNK_Tile_Background] = SNK_BACKGROUND_COLOR,
+        [_SNK_Tile_Head]       = SNK_SNAKE_HEAD_COLOR,
+        [_SNK_Tile_Body]       = SNK_SNAKE_BODY_COLOR,
+        [_SNK_Tile_Food]       = SNAKE_FOOD_COLOR,
+    };
+
+    const size_t bytes_per_pixel = SNK_DRM_Format_bytesPerPixel(format);
+    const size_t tile_stride     = renderer->_scale.x * bytes_per_pixel;
+    const size_t tile_size       = tile_stride * renderer->_scale.y;
+
+    SNK_Vec_free(&renderer->_tiles);
+
+    renderer->_tiles       = SNK_Vec_new(tile_size * _SNK_Tile_Count, sizeof(uint8_t), true);
+    renderer->_tile_format = format;
+
+    for (size_t tile = 0; tile < _SNK_Tile_Count; tile++) {
+        const auto     pixels = (uint8_t*)SNK_Vec_data(&renderer->_tiles) + tile * tile_size;
+        const uint32_t pixel  = _SNK_RGB_pack(colors[tile], format);
+
+        for (int64_t row = 0; row < renderer->_scale.y; row++)
+            _SNK_fillSpan(pixels + row * tile_stride, pixel, renderer->_scale.x, format);
+    }
+
+    SNK_Font_free(&renderer->_font);
+
+    renderer->_font = SNK_Font_new(format, _SNK_RENDERER_HUD_FONT_SCALE, _SNK_RGB_pack(SNK_HUD_TEXT_COLOR, format),
+                                   _SNK_RGB_pack(SNK_BACKGROUND_COLOR, format));
+}
+
+// Cells shown by a sprite are left as background, the plane covers them
+_SNK_Tile _SNK_Renderer_cellTile(const SNK_Renderer* renderer, const SNK_Game* game, const SNK_IVec2 pos) {
+    if (SNK_IVec2_eq(pos, game->snake_head))
+        return renderer->_sprite_count > _SNK_RENDERER_HEAD_SPRITE ? _SNK_Tile_Background : _SNK_Tile_Head;
+
+    if (SNK_Game_isOccupied(game, pos))
+        return _SNK_Tile_Body;
+
+    if (SNK_IVec2_eq(pos, game->food))
+        return renderer->_sprite_count > _SNK_RENDERER_FOOD_SPRITE ? _SNK_Tile_Background : _SNK_Tile_Food;
+
+    return _SNK_Tile_Background;
+}
+
+// Copies the rows of the cell's tile that fall in [y1, y2) of the shadow buffer
+void _SNK_Renderer_drawCellRows(const SNK_Renderer* renderer, const SNK_Game* game, const SNK_IVec2 pos,
+                                const SNK_DRM_FBInfo fbInfo, const size_t y1, const size_t y2) {
+    ASSERT(renderer->_tile_format == fbInfo.format);
+
+    const size_t bytes_per_pixel = SNK_DRM_Format_bytesPerPixel(fbInfo.format);
+    const size_t tile_stride     = renderer->_scale.x * bytes_per_pixel;
+    const size_t tile_size       = tile_stride * renderer->_scale.y;
+
+    const auto tile =
+        (const uint8_t*)SNK_Vec_data(&renderer->_tiles) + _SNK_Renderer_cellTile(renderer, game, pos) * tile_size;
+
+    _SNK_WrappedRect parts[4];
+    const size_t     part_count = _SNK_wrapRect(SNK_IVec2_mult(pos, renderer->_scale), renderer->_scale, fbInfo, parts);
+
+    for (size_t i = 0; i < part_count; i++) {
+        const _SNK_WrappedRect part = parts[i];
+
+        const size_t first = part.y > y1 ? part.y : y1;
+        const size_t last  = part.y + part.height < y2 ? part.y + part.height : y2;
+
+        for (size_t y = first; y < last; y++) {
+            const auto dst = (uint8_t*)fbInfo.shadow + y * fbInfo.stride + part.x * bytes_per_pixel;
+            const auto src = tile + (part.offset_y + y - part.y) * tile_stride + part.offset_x * bytes_per_pixel;
+
+            SNK_Blit_copy(dst, src, part.width * bytes_per_pixel);
+        }
+    }
+}
+
+// Copies the cell's tile into the shadow buffer row by row
+void _SNK_Renderer_drawCell(const SNK_Renderer* renderer, const SNK_Game* game, const SNK_IVec2 pos,
+                            const SNK_DRM_FBInfo fbInfo) {
+    _SNK_Renderer_drawCellRows(renderer, game, pos, fbInfo, 0, fbInfo.height);
+}
+
+// A full frame job split into horizontal bands of the framebuffer
+typedef struct {
+    const SNK_Renderer* renderer;
+    const SNK_Game*     game;
+    SNK_DRM_FBInfo      fbInfo;
+} _SNK_BandJob;
+
+void _SNK_bandRows(const SNK_DRM_FBInfo fbInfo, const size_t index, const size_t count, size_t* y1, size_t* y2) {
+    *y1 = fbInfo.height * index / count;
+    *y2 = fbInfo.height * (index + 1) / count;
+}
+
+// Clears the band and draws the parts of every non-background cell that overlap it
+void _SNK_Renderer_repaintBand(void* context, const size_t index, const size_t count) {
+    const _SNK_BandJob*  job    = context;
+    const SNK_DRM_FBInfo fbInfo = job->fbInfo;
+    const SNK_Game*      game   = job->game;
+
+    size_t y1, y2;
+    _SNK_bandRows(fbInfo, index, count, &y1, &y2);
+
+    const size_t bytes_per_pixel = SNK_DRM_Format_bytesPerPixel(fbInfo.format);
+    const auto   band            = (uint8_t*)fbInfo.shadow + y1 * fbInfo.stride;
+    const size_t band_size       = (y2 == fbInfo.height ? fbInfo.size : y2 * fbInfo.stride) - y1 * fbInfo.stride;
+
+    _SNK_fillSpan(band, _SNK_RGB_pack(SNK_BACKGROUND_COLOR, fbInfo.format), band_size / bytes_per_pixel,
+                  fbInfo.format);
+
+    _SNK_Renderer_drawCellRows(job->renderer, game, game->food, fbInfo, y1, y2);
+
+    for (size_t i = 0; i < SNK_Ring_size(&game->snake_body); i++) {
+        const auto body = (SNK_IVec2*)SNK_Ring_at(&game->snake_body, i);
+
+        ASSERT(body != nullptr);
+
+        _SNK_Renderer_drawCellRows(job->renderer, game, *body, fbInfo, y1, y2);
+    }
+
+    _SNK_Renderer_drawCellRows(job->renderer, game, game->snake_head, fbInfo, y1, y2);
+}
+
+// Streams the band from the shadow buffer into the mapped one
+void _SNK_Renderer_flushBand(void* context, const size_t index, const size_t count) {
+    const _SNK_BandJob*  job    = context;
+    const SNK_DRM_FBInfo fbInfo = job->fbInfo;
+
+    size_t y1, y2;
+    _SNK_bandRows(fbInfo, index, count, &y1, &y2);
+
+    const size_t offset = y1 * fbInfo.stride;
+    const size_t size   = (y2 == fbInfo.height ? fbInfo.size : y2 * fbInfo.stride) - offset;
+
+    SNK_Blit_stream((uint8_t*)fbInfo.buffer + offset, (const uint8_t*)fbInfo.shadow + offset, size);
+
+    // Non-temporal stores are only ordered by a fence on the core that issued them
+    SNK_Blit_fence();
+}
+
+// Runs a full frame job over the framebuffer, in bands on the worker pool when the frame is large enough to pay off
+void _SNK_Renderer_runBands(const SNK_Renderer* renderer, const SNK_Game* game, const SNK_DRM_FBInfo fbInfo,
+                            const SNK_WorkerPool_Job fn) {
+    _SNK_BandJob job = {
+        .renderer = renderer,
+        .game     = game,
+        .fbInfo   = fbInfo,
+    };
+
+    size_t band_count = 1;
+
+    if (renderer->_workers != nullptr) {
+        band_count = (SNK_WorkerPool_threadCount(renderer->_workers) + 1) * _SNK_RENDERER_BANDS_PER_THREAD;
+
+        if (band_count > fbInfo.size / _SNK_RENDERER_MIN_BAND_SIZE)
+            band_count = fbInfo.size / _SNK_RENDERER_MIN_BAND_SIZE;
+
+        if (band_count > fbInfo.height)
+            band_count = fbInfo.height;
+    }
+
+    if (band_count <= 1)
+        fn(&job, 0, 1);
+    else
+        SNK_WorkerPool_run(renderer->_workers, fn, &job, band_count);
+}
+
+void _SNK_Renderer_hudText(const SNK_Renderer* renderer, const SNK_Game* game, char* text, const size_t size) {
+    size_t length = SNK_appendText(text, size, 0, "SCORE ");
+
+    length = SNK_appendU64(text, size, length, game->score);
+
+    if (game->status == SNK_GameStatus_Lost)
+        length = SNK_appendText(text, size, length, " - YOU LOSE!");
+    else if (game->status == SNK_GameStatus_Won)
+        length = SNK_appendText(text, size, length, " - YOU WIN!");
+    else if (game->is_paused)
+        length = SNK_appendText(text, size, length, " - PAUSED");
+
+    if (renderer->_stats_text[0] != '\0') {
+        length = SNK_appendText(text, size, length, "   ");
+        SNK_appendText(text, size, length, renderer->_stats_text);
+    }
+}
+
+// Redraws the score line below the grid when its text changed, or always with `force`
+void _SNK_Renderer_drawHud(SNK_Renderer* renderer, const SNK_Game* game, const SNK_DRM_FBInfo fbInfo,
+                           const bool force) {
+    const size_t top         = (size_t)(game->grid.y * renderer->_scale.y);
+    const size_t line_height = SNK_Font_lineHeight(&renderer->_font);
+
+    // Grids that fill the screen leave no room for it
+    if (top + line_height > fbInfo.height)
+        return;
+
+    char text[SNK_RENDERER_HUD_TEXT_SIZE];
+    _SNK_Renderer_hudText(renderer, game, text, sizeof(text));
+
+    if (!force && strcmp(text, renderer->_hud_text) == 0)
+        return;
+
+    _SNK_fillRect(0, top, fbInfo.width, fbInfo.height - top, _SNK_RGB_pack(SNK_BACKGROUND_COLOR, fbInfo.format),
+                  fbInfo);
+    SNK_Font_drawText(&renderer->_font, fbInfo, _SNK_RENDERER_HUD_MARGIN, top + (fbInfo.height - top - line_height) / 2,
+                      text);
+
+    memcpy(renderer->_hud_text, text, sizeof(text));
+
+    renderer->_hud_rect = (SNK_DRM_Rect){
+        .x1 = 0,
+        .y1 = (uint16_t)top,
+        .x2 = (uint16_t)fbInfo.width,
+        .y2 = (uint16_t)fbInfo.height,
+    };
+
+    for (size_t i = 0; i < SNK_DRM_MAX_BUFFERS; i++)
+        renderer->_needs_hud_flush[i] = true;
+}
+
+SNK_DRM_Rect _SNK_Renderer_addRect(SNK_Renderer* renderer, const SNK_IVec2 pos, const SNK_IVec2 size,
+                                   const SNK_DRM_FBInfo fbInfo) {
+    const size_t x2 = (size_t)(pos.x + size.x) < fbInfo.width ? (size_t)(pos.x + size.x) : fbInfo.width;
+    const size_t y2 = (size_t)(pos.y + size.y) < fbInfo.height ? (size_t)(pos.y + size.y) : fbInfo.height;
+
+    const SNK_DRM_Rect rect = {
+        .x1 = (uint16_t)pos.x,
+        .y1 = (uint16_t)pos.y,
+        .x2 = (uint16_t)x2,
+        .y2 = (uint16_t)y2,
+    };
+
+    SNK_Vec_push(&renderer->_rects, &rect, sizeof(SNK_DRM_Rect));
+
+    return rect;
+}
+
+// Hands the game's changes to every buffer, each keeps them until it is flushed next
+void _SNK_Renderer_collectDamage(SNK_Renderer* renderer, const SNK_Game* game) {
+    const size_t changes = SNK_Vec_size(&game->changed_cells);
+
+    for (size_t i = 0; i < SNK_DRM_MAX_BUFFERS; i++) {
+        if (renderer->_needs_full_flush[i])
+            continue;
+
+        SNK_Vec* damage = &renderer->_damage[i];
+
+        if (SNK_Vec_size(damage) + changes > SNK_RENDERER_MAX_DAMAGE) {
+            SNK_Vec_clear(damage);
+
+            renderer->_needs_full_flush[i] = true;
+
+            continue;
+        }
+
+        for (size_t j = 0; j < changes; j++)
+            SNK_Vec_push(damage, SNK_Vec_at(&game->changed_cells, j), sizeof(size_t));
+    }
+}
+
+// Brings the shadow buffer up to date with the game, drawing each change once no matter how many buffers there are
+void _SNK_Renderer_drawShadow(SNK_Renderer* renderer, const SNK_Game* game, const SNK_DRM_FBInfo fbInfo) {
+    _SNK_Renderer_prepareTiles(renderer, fbInfo.format);
+
+    const SNK_DRM_FBInfo last = renderer->_last_shadow;
+
+    const bool is_new_shadow = fbInfo.shadow != last.shadow || fbInfo.width != last.width ||
+                               fbInfo.height != last.height || fbInfo.stride != last.stride ||
+                               fbInfo.format != last.format;
+
+    const bool is_repaint = renderer->_needs_full_repaint || is_new_shadow || game->changes_overflowed;
+
+    if (is_repaint) {
+        _SNK_Renderer_runBands(renderer, game, fbInfo, _SNK_Renderer_repaintBand);
+
+        for (size_t i = 0; i < SNK_DRM_MAX_BUFFERS; i++) {
+            SNK_Vec_clear(&renderer->_damage[i]);
+
+            renderer->_needs_full_flush[i] = true;
+        }
+    } else {
+        for (size_t i = 0; i < SNK_Vec_size(&game->changed_cells); i++) {
+            const size_t    cell = *(size_t*)SNK_Vec_at(&game->changed_cells, i);
+            const SNK_IVec2 pos  = {(int64_t)cell % game->grid.x, (int64_t)cell / game->grid.x};
+
+            _SNK_Renderer_drawCell(renderer, game, pos, fbInfo);
+        }
+
+        _SNK_Renderer_collectDamage(renderer, game);
+    }
+
+    _SNK_Renderer_drawHud(renderer, game, fbInfo, is_repaint);
+
+    renderer->_needs_full_repaint = false;
+    renderer->_last_shadow        = fbInfo;
+}
+
+// Puts the sprites over their cells, returns whether any of them moved
+bool _SNK_Renderer_moveSprites(const SNK_Renderer* renderer, const SNK_Game* game) {
+    const SNK_IVec2 positions[] = {
+        [_SNK_RENDERER_HEAD_SPRITE] = game->snake_head,
+        [_SNK_RENDERER_FOOD_SPRITE] = game->food,
+    };
+
+    bool is_moved = false;
+
+    for (size_t i = 0; i < renderer->_sprite_count; i++) {
+        const SNK_IVec2 pos = SNK_IVec2_mult(positions[i], renderer->_scale);
+
+        if (SNK_DRM_moveSprite(renderer->_drm, i, (int32_t)pos.x, (int32_t)pos.y))
+            is_moved = true;
+    }
+
+    return is_moved;
+}
+
+// Streams the rows of a rect from the shadow buffer into the mapped one
+void _SNK_Renderer_flushRect(const SNK_DRM_Rect rect, const SNK_DRM_FBInfo fbInfo) {
+    const size_t bytes_per_pixel = SNK_DRM_Format_bytesPerPixel(fbInfo.format);
+    const size_t x_offset        = (size_t)rect.x1 * bytes_per_pixel;
+    const size_t width           = (size_t)(rect.x2 - rect.x1) * bytes_per_pixel;
+
+    for (size_t y = rect.y1; y < rect.y2; y++) {
+        const size_t offset = y * fbInfo.stride + x_offset;
+
+        SNK_Blit_stream((uint8_t*)fbInfo.buffer + offset, (const uint8_t*)fbInfo.shadow + offset, width);
+    }
+}
+
+bool SNK_Renderer_render(SNK_Renderer* renderer, SNK_Game* game, const SNK_DRM_FBInfo fbInfo) {
+    ASSERT(renderer != nullptr);
+    ASSERT(game != nullptr);
+    ASSERT(fbInfo.shadow != nullptr);
+    ASSERT(fbInfo.index < SNK_DRM_MAX_BUFFERS);
+
+    // The modeset may have taken the sprites back, the cells under them have to be drawn again
+    if (renderer->_drm != nullptr && SNK_DRM_spriteCount(renderer->_drm) != renderer->_sprite_count) {
+        renderer->_sprite_count       = SNK_DRM_spriteCount(renderer->_drm);
+        renderer->_needs_full_repaint = true;
+    }
+
+    _SNK_Renderer_drawShadow(renderer, game, fbInfo);
+    SNK_Game_clearChanges(game);
+
+    const bool is_moved = _SNK_Renderer_moveSprites(renderer, game);
+
+    const SNK_DRM_FBInfo last_fb = renderer->_last_fb[fbInfo.index];
+    SNK_Vec*             damage  = &renderer->_damage[fbInfo.index];
+
+    const bool is_new_fb = fbInfo.buffer != last_fb.buffer || fbInfo.width != last_fb.width ||
+                           fbInfo.height != last_fb.height || fbInfo.stride != last_fb.stride ||
+                           fbInfo.format != last_fb.format;
+
+    SNK_Vec_clear(&renderer->_rects);
+
+    if (renderer->_needs_full_flush[fbInfo.index] || is_new_fb) {
+        _SNK_Renderer_runBands(renderer, game, fbInfo, _SNK_Renderer_flushBand);
+        _SNK_Renderer_addRect(renderer, (SNK_IVec2){0, 0}, (SNK_IVec2){(int64_t)fbInfo.width, (int64_t)fbInfo.height},
+                              fbInfo);
+    } else {
+        for (size_t i = 0; i < SNK_Vec_size(damage); i++) {
+            const size_t    cell = *(size_t*)SNK_Vec_at(damage, i);
+            const SNK_IVec2 pos  = {(int64_t)cell % game->grid.x, (int64_t)cell / game->grid.x};
+
+            const SNK_DRM_Rect rect =
+                _SNK_Renderer_addRect(renderer, SNK_IVec2_mult(pos, renderer->_scale), renderer->_scale, fbInfo);
+
+            _SNK_Renderer_flushRect(rect, fbInfo);
+        }
+
+        if (renderer->_needs_hud_flush[fbInfo.index]) {
+            SNK_Vec_push(&renderer->_rects, &renderer->_hud_rect, sizeof(SNK_DRM_Rect));
+            _SNK_Renderer_flushRect(renderer->_hud_rect, fbInfo);
+        }
+    }
+
+    SNK_Blit_fence();
+
+    SNK_Vec_clear(damage);
+
+    renderer->_needs_full_flush[fbInfo.index] = false;
+    renderer->_needs_hud_flush[fbInfo.index]  = false;
+    renderer->_last_fb[fbInfo.index]          = fbInfo;
+
+    return SNK_Vec_size(&renderer->_rects) != 0 || is_moved;
+}
+
+size_t SNK_Renderer_useSprites(SNK_Renderer* renderer, SNK_DRM* drm) {
+    ASSERT(renderer != nullptr);
+    ASSERT(drm != nullptr);
+
+    const _SNK_RGB colors[] = {
+        [_SNK_RENDERER_HEAD_SPRITE] = SNK_SNAKE_HEAD_COLOR,
+        [_SNK_RENDERER_FOOD_SPRITE] = SNAKE_FOOD_COLOR,
+    };
+
+    const size_t count = SNK_DRM_initSprites(drm, ARRSIZE(colors), renderer->_scale.x, renderer->_scale.y);
+
+    // Sprites are drawn once, moving them is all that is left to do
+    for (size_t i = 0; i < count; i++) {
+        const SNK_DRM_FBInfo sprite = SNK_DRM_getSpriteInfo(drm, i);
+        const uint32_t       pixel  = _SNK_RGB_pack(colors[i], sprite.format);
+
+        for (size_t row = 0; row < sprite.height; row++)
+            _SNK_fillSpan((uint8_t*)sprite.buffer + row * sprite.stride, pixel, sprite.width, sprite.format);
+    }
+
+    renderer->_drm                = count != 0 ? drm : nullptr;
+    renderer->_sprite_count       = count;
+    renderer->_needs_full_repaint = true;
+
+    return count;
+}
+
+void SNK_Renderer_setStatsText(SNK_Renderer* renderer, const char* text) {
+    ASSERT(renderer != nullptr);
+    ASSERT(text != nullptr);
+
+    SNK_appendText(renderer->_stats_text, sizeof(renderer->_stats_text), 0, text);
+}
+
+const SNK_DRM_Rect* SNK_Renderer_rects(const SNK_Renderer* renderer) {
+    ASSERT(renderer != nullptr);
+
+    return SNK_Vec_data(&renderer->_rects);
+}
+
+size_t SNK_Renderer_rectCount(const SNK_Renderer* renderer) {
+    ASSERT(renderer != nullptr);
+
+    return SNK_Vec_size(&renderer->_rects);
+}
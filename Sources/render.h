@@ -0,0 +1,68 @@
+#pragma once
+
+#include "drm.h"
+#include "font.h"
+#include "game.h"
+#include "vec.h"
+#include "workers.h"
+#include <stdint.h>
+
+// Rows at the bottom of the framebuffer left for the score line, below the grid
+static constexpr size_t SNK_RENDERER_HUD_HEIGHT = 32;
+
+static constexpr size_t SNK_RENDERER_HUD_TEXT_SIZE = 128;
+
+// Cells one framebuffer can fall behind by before it is cheaper to repaint it whole
+static constexpr size_t SNK_RENDERER_MAX_DAMAGE = SNK_GAME_MAX_CHANGES * SNK_DRM_MAX_BUFFERS;
+
+// Draws the game into the cached shadow buffer, repainting only the cells the game reports as changed, and then
+// streams the damaged rows into the mapped framebuffer.
+// Each page flipped buffer holds an older frame, so the changes are kept per buffer until it is flushed again.
+typedef struct {
+    SNK_IVec2 _scale;
+    bool      _needs_full_repaint;
+    // Shares full frame repaints out in bands when set, not owned
+    SNK_WorkerPool* _workers;
+    // Shadow buffer the last frame was drawn into, a different one needs a full repaint
+    SNK_DRM_FBInfo _last_shadow;
+    SNK_Vec        _damage[SNK_DRM_MAX_BUFFERS];
+    bool           _needs_full_flush[SNK_DRM_MAX_BUFFERS];
+    // Framebuffer each index was last flushed into, a different one needs the whole shadow buffer
+    SNK_DRM_FBInfo _last_fb[SNK_DRM_MAX_BUFFERS];
+    // SNK_DRM_Rect areas touched by the last frame
+    SNK_Vec _rects;
+    // Pre-rasterized cell of every appearance, one after another, for the scale and `_tile_format`
+    SNK_Vec        _tiles;
+    SNK_DRM_Format _tile_format;
+    // Score line below the grid, redrawn only when its text changes
+    SNK_Font     _font;
+    char         _hud_text[SNK_RENDERER_HUD_TEXT_SIZE];
+    SNK_DRM_Rect _hud_rect;
+    // Shown after the score, empty for none
+    char _stats_text[SNK_RENDERER_HUD_TEXT_SIZE];
+    bool _needs_hud_flush[SNK_DRM_MAX_BUFFERS];
+    // Shows the head and then the food on hardware planes, whichever of them it has sprites for, not owned
+    SNK_DRM* _drm;
+    size_t   _sprite_count;
+} SNK_Renderer;
+
+// Repaints on the calling thread alone when `workers` is nullptr
+SNK_Renderer SNK_Renderer_new(SNK_IVec2 scale, SNK_WorkerPool* workers);
+
+void SNK_Renderer_free(SNK_Renderer* renderer);
+
+void SNK_Renderer_invalidate(SNK_Renderer* renderer);
+
+bool SNK_Renderer_render(SNK_Renderer* renderer, SNK_Game* game, SNK_DRM_FBInfo fbInfo);
+
+// Sets the text shown on the score line after the score, it is redrawn with the next frame if the text changed
+void SNK_Renderer_setStatsText(SNK_Renderer* renderer, const char* text);
+
+// Moves the head and the food onto sprites where the display has planes for them, so a step only redraws the cells
+// the body changed. Returns how many of the two it got, the rest are drawn into the framebuffer as before.
+size_t SNK_Renderer_useSprites(SNK_Renderer* renderer, SNK_DRM* drm);
+
+// Areas of the framebuffer the last render call drew into, to pass on to SNK_DRM_present
+const SNK_DRM_Rect* SNK_Renderer_rects(const SNK_Renderer* renderer);
+
+size_t SNK_Renderer_rectCount(const SNK_Renderer* renderer);
@@ -1,4 +1,5 @@
 #include "shell.h"
+#include "loop.h"
 #include "snake.h"
 #include "utils.h"
 #include <dirent.h>
@@ -207,6 +208,96 @@ cleanup:
         close(dst_f);
 }
 
+// Parses `[autopilot] [legacy] [tearing] [rgb565] [scaled] [mode <MODE>] [record <PATH> | replay <PATH>] [SEED]`,
+// `args` points at the space after the command
+bool _SNK_parseSnakeArgs(char* args, SNK_SnakeOptions* options) {
+    while (args != nullptr) {
+        *args = '\0';
+
+        char* token = args + 1;
+
+        args = strchr(token, ' ');
+
+        if (args != nullptr)
+            *args = '\0';
+
+        if (*token == '\0')
+            continue;
+
+        if (strcmp(token, "autopilot") == 0) {
+            options->autopilot = true;
+
+            continue;
+        }
+
+        if (strcmp(token, "legacy") == 0) {
+            options->legacy_kms = true;
+
+            continue;
+        }
+
+        if (strcmp(token, "tearing") == 0) {
+            options->async_flip = true;
+
+            continue;
+        }
+
+        if (strcmp(token, "rgb565") == 0) {
+            options->rgb565 = true;
+
+            continue;
+        }
+
+        if (strcmp(token, "scaled") == 0) {
+            options->plane_scaling = true;
+
+            continue;
+        }
+
+        const bool is_record = strcmp(token, "record") == 0;
+        const bool is_mode   = strcmp(token, "mode") == 0;
+
+        if (is_record || is_mode || strcmp(token, "replay") == 0) {
+            char* value = args != nullptr ? args + 1 : nullptr;
+
+            if (value == nullptr || *value == '\0' || *value == ' ') {
+                printf("snake: missing %s for '%s'\n", is_mode ? "mode" : "path", token);
+
+                return false;
+            }
+
+            args = strchr(value, ' ');
+
+            if (is_record)
+                options->record_path = value;
+            else if (is_mode)
+                options->mode = value;
+            else
+                options->replay_path = value;
+
+            continue;
+        }
+
+        if (!SNK_parseU64(token, &options->seed)) {
+            printf("snake: invalid argument '%s'\n", token);
+
+            return false;
+        }
+
+        options->has_seed = true;
+    }
+
+    const bool has_game_options = options->has_seed || options->record_path != nullptr || options->autopilot;
+
+    if (options->replay_path != nullptr && has_game_options) {
+        printf("snake: a replay can't be combined with a seed, a recording or the autopilot\n");
+
+        return false;
+    }
+
+    return true;
+}
+
 void _SNK_help() {
     printf("Available commands:\n"
            "cat <PATH> - print content of the file\n"
@@ -214,20 +305,61 @@ void _SNK_help() {
            "cp <SRC> <DST> - copy file\n"
            "write <PATH> <MSG> - write message to the file\n"
            "quit/q - exit the shell and reboot\n"
-           "snake - run the snake game\n"
+           "snake [autopilot] [legacy] [tearing] [rgb565] [scaled] [mode <MODE>] [record <PATH>] [SEED] - "
+           "run the snake game\n"
+           "    autopilot - let the autopilot steer\n"
+           "    legacy - use legacy modesetting instead of atomic commits\n"
+           "    tearing - flip frames without waiting for vblank, for lower latency\n"
+           "    rgb565 - render in 16-bit color to halve the memory traffic\n"
+           "    scaled - render a pixel per cell and let the display scale it up, without the score line\n"
+           "    mode <MODE> - preferred, smallest or a mode like 1280x720@60, defaults to snake.mode= on the\n"
+           "        kernel command line\n"
+           "    record <PATH> - record the input of every tick to the file\n"
+           "    SEED - use a fixed RNG seed\n"
+           "snake [legacy] [tearing] [rgb565] [scaled] [mode <MODE>] replay <PATH> - "
+           "replay a recorded game as fast as possible\n"
            "help - print this message\n");
 }
 
+// What one read of the console returned, a whole line in canonical mode
+typedef struct {
+    char    text[512];
+    ssize_t size;
+    bool    is_read;
+} _SNK_ConsoleLine;
+
+void _SNK_onConsole(void* context, const uint32_t events) {
+    _SNK_ConsoleLine* line = context;
+
+    line->size    = read(STDIN_FILENO, line->text, sizeof(line->text));
+    line->is_read = true;
+}
+
 void SNK_shell() {
     printf("Welcome to SnakeOS shell!\n");
     _SNK_help();
 
+    // Later games reuse the display the first one set up
+    SNK_SnakeSession session = {};
+
+    // The console is waited on like every other source, so more can be watched alongside it
+    SNK_EventLoop    loop = {};
+    _SNK_ConsoleLine line = {};
+
+    if (!SNK_EventLoop_open(&loop) || !SNK_EventLoop_add(&loop, STDIN_FILENO, EPOLLIN, _SNK_onConsole, &line))
+        SNK_crash("Failed to watch the console: %s", strerror(errno));
+
     while (1) {
         printf("$ ");
         fflush(stdout);
 
-        char   buf[512];
-        size_t bytes = read(STDIN_FILENO, buf, sizeof(buf));
+        line.is_read = false;
+
+        while (!line.is_read)
+            SNK_EventLoop_dispatch(&loop, -1);
+
+        char*  buf   = line.text;
+        size_t bytes = line.size;
 
         if (bytes <= 1)
             continue;
@@ -322,7 +454,19 @@ void SNK_shell() {
         }
 
         if (strncmp(buf, "snake", 5) == 0) {
-            SNK_snake();
+            SNK_SnakeOptions options = {};
+
+            if (!_SNK_parseSnakeArgs(strchr(buf, ' '), &options))
+                continue;
+
+            // The game points stdin at another tty, which epoll would not follow
+            if (!SNK_EventLoop_remove(&loop, STDIN_FILENO))
+                SNK_crash("Failed to stop watching the console: %s", strerror(errno));
+
+            SNK_snake(&options, &session);
+
+            if (!SNK_EventLoop_add(&loop, STDIN_FILENO, EPOLLIN, _SNK_onConsole, &line))
+                SNK_crash("Failed to watch the console: %s", strerror(errno));
 
             continue;
         }
@@ -335,4 +479,7 @@ void SNK_shell() {
 
         printf("Unknown command: '%s'\n", buf);
     }
+
+    SNK_SnakeSession_close(&session);
+    SNK_EventLoop_close(&loop);
 }
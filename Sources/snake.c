@@ -1,319 +1,460 @@
 #include "snake.h"
+#include "autopilot.h"
 #include "drm.h"
+#include "game.h"
 #include "input.h"
+#include "loop.h"
+#include "rand.h"
+#include "record.h"
+#include "render.h"
+#include "stats.h"
+#include "timer.h"
 #include "utils.h"
-#include "vec.h"
+#include "workers.h"
 #include <stdio.h>
 
-uint64_t _SNK_rand() {
-    const int fd = open("/dev/urandom", O_RDONLY);
+// Ticks run back to back after a stall before the simulation gives up catching up
+constexpr uint64_t SNK_MAX_CATCHUP_TICKS = 5;
 
-    if (fd == -1)
-        SNK_crash("Failed to open /dev/urandom: %s", strerror(errno));
+// Double buffered: a frame is drawn off screen while the previous one is scanned out
+constexpr size_t SNK_FRAMEBUFFERS = 2;
 
-    uint64_t rand = 0;
+// Frames between updates of the live stats, so the score line isn't redrawn every frame
+constexpr uint64_t SNK_LIVE_STATS_FRAMES = 15;
 
-    if (read(fd, &rand, sizeof(rand)) != sizeof(rand))
-        SNK_crash("Failed to read from /dev/urandom: %s", strerror(errno));
+constexpr uint16_t SNK_STATS_KEY = KEY_F3;
 
-    close(fd);
+// Display pixels across a cell
+constexpr int64_t SNK_CELL_SIZE = 26;
 
-    return rand;
-}
+SNK_GameInput _SNK_readKeyboard(SNK_Keyboard* keyboard, const bool has_events) {
+    ASSERT(keyboard != nullptr);
 
-uint64_t _SNK_randRange(const uint64_t min, const uint64_t max) { return min + (_SNK_rand() % (max - min)); }
+    SNK_Keyboard_update(keyboard, has_events);
 
-typedef struct {
-    int64_t x;
-    int64_t y;
-} _SNK_IVec2;
+    SNK_GameInput input = 0;
+
+    if (SNK_Keyboard_wasPressed(keyboard, KEY_ESC))
+        input |= SNK_GameInput_Pause;
+
+    if (SNK_Keyboard_isPressed(keyboard, KEY_LEFTCTRL) && SNK_Keyboard_wasPressed(keyboard, KEY_C))
+        input |= SNK_GameInput_Quit;
+
+    if (SNK_Keyboard_isPressed(keyboard, KEY_W) || SNK_Keyboard_isPressed(keyboard, KEY_UP))
+        input |= SNK_GameInput_Up;
+
+    if (SNK_Keyboard_isPressed(keyboard, KEY_S) || SNK_Keyboard_isPressed(keyboard, KEY_DOWN))
+        input |= SNK_GameInput_Down;
+
+    if (SNK_Keyboard_isPressed(keyboard, KEY_A) || SNK_Keyboard_isPressed(keyboard, KEY_LEFT))
+        input |= SNK_GameInput_Left;
 
-_SNK_IVec2 _SNK_IVec2_mult(const _SNK_IVec2 a, const _SNK_IVec2 b) { return (_SNK_IVec2){a.x * b.x, a.y * b.y}; }
+    if (SNK_Keyboard_isPressed(keyboard, KEY_D) || SNK_Keyboard_isPressed(keyboard, KEY_RIGHT))
+        input |= SNK_GameInput_Right;
 
-bool _SNK_IVec2_eq(const _SNK_IVec2 a, const _SNK_IVec2 b) { return a.x == b.x && a.y == b.y; }
+    if (SNK_Keyboard_isPressed(keyboard, KEY_LEFTSHIFT))
+        input |= SNK_GameInput_Boost;
+
+    return input;
+}
 
+// Where the game input comes from besides the keyboard, each one is optional
 typedef struct {
-    uint8_t r;
-    uint8_t g;
-    uint8_t b;
-} _SNK_RGB;
-
-typedef enum {
-    SNK_Direction_Up,
-    SNK_Direction_Down,
-    SNK_Direction_Left,
-    SNK_Direction_Right,
-} _SNK_Direction;
+    SNK_Replay*    replay;
+    SNK_Recorder*  recorder;
+    SNK_Autopilot* autopilot;
+} _SNK_InputSources;
 
+// What the event loop found ready since the frame before
 typedef struct {
-    bool           is_paused;
-    bool           quit;
-    size_t         score;
-    _SNK_IVec2     grid;
-    _SNK_IVec2     scale;
-    float          move_progress;
-    float          move_speed;
-    _SNK_Direction direction;
-    _SNK_IVec2     snake_head;
-    _SNK_IVec2     food;
-    // SNK_IVec2
-    SNK_Vec snake_body;
-} SNK_Game;
-
-const _SNK_RGB  SNK_SNAKE_HEAD_COLOR = {2, 181, 38};
-const _SNK_RGB  SNK_SNAKE_BODY_COLOR = {38, 126, 5};
-const _SNK_RGB  SNAKE_FOOD_COLOR     = {240, 255, 0};
-constexpr float SNK_DELTA_TIME       = 0.033f;
-
-int64_t _SNK_wrap(const int64_t value, const int64_t min, const int64_t max) {
-    if (value < min)
-        return max - (min - value);
-
-    if (value >= max)
-        return min + (value - max);
-
-    return value;
+    SNK_Timer* timer;
+    SNK_DRM*   drm;
+    // Frame periods that went by
+    uint64_t ticks;
+    // New key events are queued, the input device is only read then
+    bool has_input;
+} _SNK_FrameEvents;
+
+void _SNK_onFrameTimer(void* context, const uint32_t events) {
+    _SNK_FrameEvents* frame = context;
+
+    frame->ticks += SNK_Timer_wait(frame->timer);
+}
+
+void _SNK_onInput(void* context, const uint32_t events) {
+    _SNK_FrameEvents* frame = context;
+
+    frame->has_input = true;
 }
 
-bool _SNK_isThereBody(const SNK_Game* game, const _SNK_IVec2 pos, const _SNK_IVec2* target) {
-    const _SNK_IVec2 wrapped_pos = {_SNK_wrap(pos.x, 0, game->grid.x), _SNK_wrap(pos.y, 0, game->grid.y)};
+// Page flips are taken in as they complete, so drawing the next frame doesn't have to block on them
+void _SNK_onPageFlip(void* context, const uint32_t events) {
+    _SNK_FrameEvents* frame = context;
 
-    if (target != nullptr)
-        return _SNK_IVec2_eq(wrapped_pos, *target);
+    if (!SNK_DRM_handleEvents(frame->drm))
+        SNK_crash("Failed to handle DRM events");
+}
 
-    for (size_t i = 0; i < SNK_Vec_size(&game->snake_body); i++) {
-        const auto body = (_SNK_IVec2*)SNK_Vec_at(&game->snake_body, i);
+void _SNK_tick(SNK_Game* game, SNK_Keyboard* keyboard, _SNK_FrameEvents* frame, const _SNK_InputSources* sources,
+               SNK_FrameStats* stats) {
+    const uint64_t start = SNK_Timer_now();
 
-        ASSERT(body != nullptr);
+    SNK_GameInput input = _SNK_readKeyboard(keyboard, frame->has_input);
 
-        if (body->x == pos.x && body->y == pos.y)
-            return true;
+    // The first read drains the device, later ticks of the same frame have nothing new until the next wake-up
+    frame->has_input = false;
+
+    if (sources->replay != nullptr) {
+        // The keyboard can still abort a replay, everything else comes from the recording
+        const bool is_aborted = input & SNK_GameInput_Quit;
+
+        if (!SNK_Replay_next(sources->replay, &input) || is_aborted)
+            input = SNK_GameInput_Quit;
+    } else if (sources->autopilot != nullptr) {
+        // The keyboard keeps pause and quit, the autopilot steers
+        input = (input & (SNK_GameInput_Pause | SNK_GameInput_Quit)) | SNK_Autopilot_input(sources->autopilot, game);
     }
 
-    return false;
+    const uint64_t input_end = SNK_Timer_now();
+
+    if (sources->recorder != nullptr)
+        SNK_Recorder_push(sources->recorder, input);
+
+    SNK_Game_tick(game, input, sources->replay != nullptr ? sources->replay->header.delta_time : SNK_DELTA_TIME);
+
+    SNK_FrameStats_record(stats, SNK_FramePhase_Input, input_end - start);
+    SNK_FrameStats_record(stats, SNK_FramePhase_Tick, SNK_Timer_now() - input_end);
 }
 
-_SNK_IVec2 _SNK_move(const _SNK_IVec2 pos, const _SNK_Direction direction) {
-    switch (direction) {
-    case SNK_Direction_Up:
-        return (_SNK_IVec2){pos.x, pos.y - 1};
-    case SNK_Direction_Down:
-        return (_SNK_IVec2){pos.x, pos.y + 1};
-    case SNK_Direction_Left:
-        return (_SNK_IVec2){pos.x - 1, pos.y};
-    case SNK_Direction_Right:
-        return (_SNK_IVec2){pos.x + 1, pos.y};
-    default:
-        ASSERT(false);
-    }
+bool _SNK_DRM_Options_eq(const SNK_DRM_Options* a, const SNK_DRM_Options* b) {
+    const bool is_named = a->mode_policy == SNK_DRM_ModePolicy_Named;
+
+    return a->buffer_count == b->buffer_count && a->atomic == b->atomic && a->async_flip == b->async_flip &&
+           a->format == b->format && a->mode_policy == b->mode_policy && a->scale == b->scale &&
+           (!is_named || strcmp(a->mode_name, b->mode_name) == 0);
 }
 
-void _SNK_tick(SNK_Game* game, SNK_Keyboard* keyboard) {
-    ASSERT(game != nullptr);
-    ASSERT(keyboard != nullptr);
+void SNK_SnakeSession_close(SNK_SnakeSession* session) {
+    ASSERT(session != nullptr);
 
-    SNK_Keyboard_update(keyboard);
+    if (session->_is_open)
+        SNK_DRM_free(&session->_drm);
 
-    if (SNK_Keyboard_wasPressed(keyboard, KEY_ESC)) {
-        game->is_paused = !game->is_paused;
+    *session = (SNK_SnakeSession){};
+}
 
-        return;
+// Takes the display back from the console if the last game left it open with the same options, opens it otherwise
+bool _SNK_SnakeSession_open(SNK_SnakeSession* session, const SNK_DRM_Options* options) {
+    if (session->_is_open) {
+        if (_SNK_DRM_Options_eq(&session->_options, options) && SNK_DRM_resetFB(&session->_drm)) {
+            printf("Reusing the display of the last game\n");
+
+            return true;
+        }
+
+        SNK_SnakeSession_close(session);
     }
 
-    if (SNK_Keyboard_isPressed(keyboard, KEY_LEFTCTRL) && SNK_Keyboard_wasPressed(keyboard, KEY_C)) {
-        game->quit = true;
+    if (!SNK_DRM_open("/dev/dri/card0", &session->_drm)) {
+        printf("Failed to open DRM device: %s\n", strerror(errno));
 
-        return;
+        return false;
     }
 
-    const _SNK_IVec2* first_body = SNK_Vec_at(&game->snake_body, 0);
-
-    if (SNK_Keyboard_isPressed(keyboard, KEY_W) || SNK_Keyboard_isPressed(keyboard, KEY_UP)) {
-        if (!_SNK_isThereBody(game, (_SNK_IVec2){game->snake_head.x, game->snake_head.y - 1}, first_body))
-            game->direction = SNK_Direction_Up;
-    } else if (SNK_Keyboard_isPressed(keyboard, KEY_S) || SNK_Keyboard_isPressed(keyboard, KEY_DOWN)) {
-        if (!_SNK_isThereBody(game, (_SNK_IVec2){game->snake_head.x, game->snake_head.y + 1}, first_body))
-            game->direction = SNK_Direction_Down;
-    } else if (SNK_Keyboard_isPressed(keyboard, KEY_A) || SNK_Keyboard_isPressed(keyboard, KEY_LEFT)) {
-        if (!_SNK_isThereBody(game, (_SNK_IVec2){game->snake_head.x - 1, game->snake_head.y}, first_body))
-            game->direction = SNK_Direction_Left;
-    } else if (SNK_Keyboard_isPressed(keyboard, KEY_D) || SNK_Keyboard_isPressed(keyboard, KEY_RIGHT)) {
-        if (!_SNK_isThereBody(game, (_SNK_IVec2){game->snake_head.x + 1, game->snake_head.y}, first_body))
-            game->direction = SNK_Direction_Right;
+    session->_is_open = true;
+
+    if (!SNK_DRM_initFB(&session->_drm, options)) {
+        printf("Failed to initialize framebuffer\n");
+
+        SNK_SnakeSession_close(session);
+
+        return false;
     }
 
-    if (game->is_paused)
-        return;
+    // The name is the caller's, the copy has to outlive it
+    session->_options = *options;
 
-    if (SNK_Keyboard_isPressed(keyboard, KEY_LEFTSHIFT))
-        game->move_progress += game->move_speed * 2.0f * SNK_DELTA_TIME;
-    else
-        game->move_progress += game->move_speed * SNK_DELTA_TIME;
+    if (options->mode_name != nullptr) {
+        SNK_appendText(session->_mode_name, sizeof(session->_mode_name), 0, options->mode_name);
 
-    if (game->move_progress >= 1.0f) {
-        _SNK_IVec2 prev_pos = game->snake_head;
+        session->_options.mode_name = session->_mode_name;
+    }
 
-        game->move_progress = 0.0f;
-        game->snake_head    = _SNK_move(game->snake_head, game->direction);
+    return true;
+}
 
-        game->snake_head.x = _SNK_wrap(game->snake_head.x, 0, game->grid.x);
-        game->snake_head.y = _SNK_wrap(game->snake_head.y, 0, game->grid.y);
+// Turns "preferred", "smallest" or a mode name into a mode policy, the name has to outlive SNK_DRM_initFB
+void _SNK_setModePolicy(SNK_DRM_Options* drm_options, const char* mode) {
+    if (strcmp(mode, "preferred") == 0) {
+        drm_options->mode_policy = SNK_DRM_ModePolicy_Preferred;
+    } else if (strcmp(mode, "smallest") == 0) {
+        drm_options->mode_policy = SNK_DRM_ModePolicy_Smallest;
+    } else {
+        drm_options->mode_policy = SNK_DRM_ModePolicy_Named;
+        drm_options->mode_name   = mode;
+    }
+}
 
-        for (size_t i = 0; i < SNK_Vec_size(&game->snake_body); i++) {
-            const auto       body      = (_SNK_IVec2*)SNK_Vec_at(&game->snake_body, i);
-            const _SNK_IVec2 body_copy = *body;
+void SNK_snake(const SNK_SnakeOptions* options, SNK_SnakeSession* session) {
+    ASSERT(options != nullptr);
+    ASSERT(session != nullptr);
 
-            ASSERT(body != nullptr);
+    SNK_switchConsoleTo("/dev/ttyAMA0");
 
-            if (_SNK_IVec2_eq(*body, game->snake_head)) {
-                game->quit = true;
+    SNK_DRM_Options drm_options = {
+        .buffer_count = SNK_FRAMEBUFFERS,
+        .atomic       = !options->legacy_kms,
+        .async_flip   = options->async_flip,
+        .format       = options->rgb565 ? SNK_DRM_Format_RGB565 : SNK_DRM_Format_XRGB8888,
+        .mode_policy  = SNK_DRM_ModePolicy_Preferred,
+        .scale        = options->plane_scaling ? SNK_CELL_SIZE : 1,
+    };
 
-                printf("You lose! Score: %lu\n", game->score);
+    // Lets each deployment trade resolution for frame time without a rebuild
+    char kernel_mode[SNK_SNAKE_MODE_NAME_SIZE];
 
-                return;
-            }
+    if (options->mode != nullptr)
+        _SNK_setModePolicy(&drm_options, options->mode);
+    else if (SNK_kernelArg("snake.mode", kernel_mode, sizeof(kernel_mode)))
+        _SNK_setModePolicy(&drm_options, kernel_mode);
 
-            if (_SNK_IVec2_eq(*body, prev_pos)) {
-                continue;
-            }
+    if (!_SNK_SnakeSession_open(session, &drm_options)) {
+        SNK_switchConsoleTo("/dev/tty0");
 
-            *body    = prev_pos;
-            prev_pos = body_copy;
-        }
+        return;
     }
 
-    if (_SNK_IVec2_eq(game->snake_head, game->food)) {
-        game->score++;
-        game->move_speed += 0.05f;
+    SNK_DRM* drm = &session->_drm;
 
-        const _SNK_IVec2 new_body = {game->snake_head.x, game->snake_head.y};
-        SNK_Vec_push(&game->snake_body, &new_body, sizeof(_SNK_IVec2));
+    SNK_Keyboard keyboard = {};
 
-        if (SNK_Vec_size(&game->snake_body) + 1 == game->grid.x * game->grid.y) {
-            game->quit = true;
+    do {
+        SNK_InputDevice input = {};
 
-            printf("You win! Score: %lu\n", game->score);
+        if (!SNK_InputDevice_open(&input, "/dev/input/event0")) {
+            printf("Failed to open input device: %s\n", strerror(errno));
 
-            return;
+            goto cleanup;
         }
 
-        while (true) {
-        spawn_food:
-            game->food =
-                (_SNK_IVec2){(int64_t)_SNK_randRange(0, game->grid.x), (int64_t)_SNK_randRange(0, game->grid.y)};
+        keyboard = SNK_Keyboard_new(input);
+    } while (false);
+
+    SNK_DRM_FBInfo fbInfo = SNK_DRM_getFBInfo(drm);
 
-            if (_SNK_IVec2_eq(game->food, game->snake_head)) {
-                goto spawn_food;
-            }
+    // A framebuffer the plane scales up has a pixel per cell, which leaves no room for the score line
+    const bool is_scaled = SNK_DRM_scale(drm) > 1;
 
-            for (size_t i = 0; i < SNK_Vec_size(&game->snake_body); i++) {
-                const auto body = (_SNK_IVec2*)SNK_Vec_at(&game->snake_body, i);
+    const SNK_IVec2 scale  = is_scaled ? (SNK_IVec2){1, 1} : (SNK_IVec2){SNK_CELL_SIZE, SNK_CELL_SIZE};
+    const SNK_IVec2 screen = {(int64_t)fbInfo.width / scale.x, (int64_t)fbInfo.height / scale.y};
+    // The bottom rows are left to the score line
+    const SNK_IVec2 grid = {
+        screen.x,
+        is_scaled ? screen.y : ((int64_t)fbInfo.height - (int64_t)SNK_RENDERER_HUD_HEIGHT) / scale.y,
+    };
 
-                ASSERT(body != nullptr);
+    SNK_Replay   replay   = {};
+    SNK_Recorder recorder = {};
 
-                if (_SNK_IVec2_eq(game->food, *body))
-                    goto spawn_food;
-            }
+    SNK_RecordHeader header = {
+        .seed       = options->has_seed ? options->seed : SNK_Rand_kernelSeed(),
+        .grid       = grid,
+        .delta_time = SNK_DELTA_TIME,
+    };
 
-            break;
+    if (options->replay_path != nullptr) {
+        if (!SNK_Replay_open(&replay, options->replay_path)) {
+            printf("Failed to open replay '%s': %s\n", options->replay_path, strerror(errno));
+
+            goto cleanup;
         }
-    }
-}
 
-void _SNK_drawRect(const _SNK_IVec2 pos, const _SNK_IVec2 size, const _SNK_RGB color, const SNK_DRM_FBInfo fbInfo) {
-    for (size_t y = pos.y; y < pos.y + size.y; y++) {
-        for (size_t x = pos.x; x < pos.x + size.x; x++) {
-            const size_t y_wrapped = _SNK_wrap((int64_t)y, 0, (int64_t)fbInfo.height);
-            const size_t x_wrapped = _SNK_wrap((int64_t)x, 0, (int64_t)fbInfo.width);
+        header = replay.header;
 
-            const size_t offset = y_wrapped * fbInfo.stride + x_wrapped * 4;
+        // Replays may cover the score line, it is left out when there is no room for it
+        if (header.grid.x > screen.x || header.grid.y > screen.y) {
+            printf("Replay grid %lld x %lld does not fit the screen\n", header.grid.x, header.grid.y);
 
-            fbInfo.buffer[offset / 4] = (color.r << 16) | (color.g << 8) | color.b;
+            SNK_Replay_free(&replay);
+
+            goto cleanup;
         }
     }
-}
 
-void _SNK_render(const SNK_Game* game, const SNK_DRM* drm, const SNK_DRM_FBInfo fbInfo) {
-    ASSERT(game != nullptr);
+    if (options->record_path != nullptr && !SNK_Recorder_open(&recorder, options->record_path, &header)) {
+        printf("Failed to open recording '%s': %s\n", options->record_path, strerror(errno));
 
-    memset(fbInfo.buffer, 0, fbInfo.size);
+        if (options->replay_path != nullptr)
+            SNK_Replay_free(&replay);
 
-    _SNK_drawRect(_SNK_IVec2_mult(game->food, game->scale), game->scale, SNAKE_FOOD_COLOR, fbInfo);
+        goto cleanup;
+    }
 
-    for (size_t i = 0; i < SNK_Vec_size(&game->snake_body); i++) {
-        const auto body = (_SNK_IVec2*)SNK_Vec_at(&game->snake_body, i);
+    SNK_Game game = SNK_Game_new(header.grid, header.seed);
 
-        ASSERT(body != nullptr);
+    printf("** Game Info **\n");
+    printf("- Grid: %lld x %lld\n", game.grid.x, game.grid.y);
+    printf("- Scale: %lld x %lld\n", scale.x, scale.y);
+    printf("- Seed: %llu\n", header.seed);
 
-        _SNK_drawRect(_SNK_IVec2_mult(*body, game->scale), game->scale, SNK_SNAKE_BODY_COLOR, fbInfo);
-    }
+    if (options->replay_path != nullptr)
+        printf("- Replay: %lu ticks\n", SNK_Replay_size(&replay));
 
-    _SNK_drawRect(_SNK_IVec2_mult(game->snake_head, game->scale), game->scale, SNK_SNAKE_HEAD_COLOR, fbInfo);
+    SNK_Autopilot autopilot = {};
 
-    if (!SNK_DRM_refresh(drm))
-        SNK_crash("Failed to refresh DRM device");
-}
+    if (options->autopilot)
+        autopilot = SNK_Autopilot_new(game.grid);
 
-void SNK_snake() {
-    SNK_DRM drm;
+    const _SNK_InputSources sources = {
+        .replay    = options->replay_path != nullptr ? &replay : nullptr,
+        .recorder  = options->record_path != nullptr ? &recorder : nullptr,
+        .autopilot = options->autopilot ? &autopilot : nullptr,
+    };
 
-    SNK_switchConsoleTo("/dev/ttyAMA0");
-    
-    if (!SNK_DRM_open("/dev/dri/card0", &drm)) {
-        printf("Failed to open DRM device: %s\n", strerror(errno));
+    // Full repaints are split across every core, the main thread takes a share of the bands too
+    SNK_WorkerPool workers = {};
 
-        return;
-    }
+    if (!SNK_WorkerPool_open(&workers, SNK_WorkerPool_cpuCount() - 1))
+        printf("Failed to start render workers, repainting on one core\n");
 
-    if (!SNK_DRM_initFB(&drm)) {
-        printf("Failed to initialize framebuffer\n");
+    SNK_Renderer renderer = SNK_Renderer_new(scale, SNK_WorkerPool_threadCount(&workers) != 0 ? &workers : nullptr);
+    SNK_Timer    timer    = {};
 
-        goto cleanup;
-    }
+    // The display composites the head and food where it has spare planes, leaving a step fewer cells to redraw
+    SNK_Renderer_useSprites(&renderer, drm);
 
-    SNK_Keyboard keyboard = {};
+    if (!SNK_Timer_open(&timer, (uint64_t)(SNK_DELTA_TIME * 1000000000.0 + 0.5)))
+        SNK_crash("Failed to create frame timer: %s", strerror(errno));
 
-    do {
-        SNK_InputDevice input = {};
+    // One wait covers the frame timer, the keyboard and page flips, each wake-up handles only what is ready
+    SNK_EventLoop    loop  = {};
+    _SNK_FrameEvents frame = {
+        .timer = &timer,
+        .drm   = drm,
+    };
 
-        if (!SNK_InputDevice_open(&input, "/dev/input/event0")) {
-            printf("Failed to open input device: %s\n", strerror(errno));
+    if (!SNK_EventLoop_open(&loop))
+        SNK_crash("Failed to create event loop: %s", strerror(errno));
 
-            goto cleanup;
+    // Replays don't wait for the timer
+    bool is_watched = sources.replay != nullptr ||
+                      SNK_EventLoop_add(&loop, SNK_Timer_fd(&timer), EPOLLIN, _SNK_onFrameTimer, &frame);
+
+    // Edge triggered, the ticks read the keyboard and until they do its queue would keep waking the loop
+    is_watched = is_watched &&
+                 SNK_EventLoop_add(&loop, SNK_Keyboard_fd(&keyboard), EPOLLIN | EPOLLET, _SNK_onInput, &frame);
+    is_watched = is_watched && SNK_EventLoop_add(&loop, SNK_DRM_fd(drm), EPOLLIN, _SNK_onPageFlip, &frame);
+
+    if (!is_watched)
+        SNK_crash("Failed to watch the game's events: %s", strerror(errno));
+
+    // Histograms are fixed size, nothing in the loop allocates for them
+    SNK_FrameStats stats;
+    SNK_FrameStats_reset(&stats);
+
+    bool     show_stats = false;
+    uint64_t frames     = 0;
+
+    while (!SNK_Game_isOver(&game)) {
+        // Replays run unthrottled, one tick per frame, to give a repeatable load for profiling
+        if (sources.replay != nullptr) {
+            SNK_EventLoop_dispatch(&loop, 0);
+
+            frame.ticks = 1;
         }
 
-        keyboard = SNK_Keyboard_new(input);
-    } while (false);
+        while (frame.ticks == 0)
+            SNK_EventLoop_dispatch(&loop, -1);
 
-    const SNK_DRM_FBInfo fbInfo = SNK_DRM_getFBInfo(&drm);
+        uint64_t ticks = frame.ticks;
+        frame.ticks    = 0;
 
-    const _SNK_IVec2 scale = {26, 26};
-    const _SNK_IVec2 grid  = {(int64_t)fbInfo.width / scale.x, (int64_t)fbInfo.height / scale.y};
-    const _SNK_IVec2 food  = {(int64_t)_SNK_randRange(0, grid.x), (int64_t)_SNK_randRange(0, grid.y)};
+        const uint64_t frame_start = SNK_Timer_now();
 
-    SNK_Game game = {
-        .grid       = grid,
-        .scale      = scale,
-        .direction  = SNK_Direction_Right,
-        .move_speed = 1.0f,
-        .snake_head = {grid.x / 2, grid.y / 2},
-        .snake_body = SNK_Vec_new(64, sizeof(_SNK_IVec2), false),
-        .food       = food,
-    };
+        // Every period past the first went by without a frame
+        if (ticks > 1)
+            SNK_FrameStats_missDeadlines(&stats, ticks - 1);
 
-    printf("** Game Info **\n");
-    printf("- Grid: %lld x %lld\n", game.grid.x, game.grid.y);
-    printf("- Scale: %lld x %lld\n", game.scale.x, game.scale.y);
+        if (ticks > SNK_MAX_CATCHUP_TICKS)
+            ticks = SNK_MAX_CATCHUP_TICKS;
+
+        for (uint64_t i = 0; i < ticks && !SNK_Game_isOver(&game); i++) {
+            _SNK_tick(&game, &keyboard, &frame, &sources, &stats);
+
+            if (SNK_Keyboard_wasPressed(&keyboard, SNK_STATS_KEY)) {
+                show_stats = !show_stats;
+                frames     = 0;
+
+                SNK_Renderer_setStatsText(&renderer, "");
+            }
+        }
+
+        if (show_stats && frames % SNK_LIVE_STATS_FRAMES == 0) {
+            char text[SNK_RENDERER_HUD_TEXT_SIZE];
+
+            SNK_FrameStats_formatLive(&stats, text, sizeof(text));
+            SNK_Renderer_setStatsText(&renderer, text);
+        }
+
+        const uint64_t acquire_start = SNK_Timer_now();
+
+        fbInfo = SNK_DRM_getFBInfo(drm);
 
-    while (!game.quit) {
-        _SNK_tick(&game, &keyboard);
-        _SNK_render(&game, &drm, fbInfo);
+        const uint64_t render_start = SNK_Timer_now();
+        const bool     is_drawn     = SNK_Renderer_render(&renderer, &game, fbInfo);
+        const uint64_t render_end   = SNK_Timer_now();
 
-        msleep((unsigned int)(SNK_DELTA_TIME * 1000));
+        if (is_drawn && !SNK_DRM_present(drm, SNK_Renderer_rects(&renderer), SNK_Renderer_rectCount(&renderer)))
+            SNK_crash("Failed to present frame");
+
+        const uint64_t frame_end  = SNK_Timer_now();
+        const uint64_t present_ns = (render_start - acquire_start) + (frame_end - render_end);
+
+        SNK_FrameStats_record(&stats, SNK_FramePhase_Render, render_end - render_start);
+        SNK_FrameStats_record(&stats, SNK_FramePhase_Present, present_ns);
+        SNK_FrameStats_record(&stats, SNK_FramePhase_Frame, frame_end - frame_start);
+
+        frames++;
     }
 
+    // One last frame puts the result on screen
+    fbInfo = SNK_DRM_getFBInfo(drm);
+
+    if (SNK_Renderer_render(&renderer, &game, fbInfo) &&
+        !SNK_DRM_present(drm, SNK_Renderer_rects(&renderer), SNK_Renderer_rectCount(&renderer)))
+        SNK_crash("Failed to present frame");
+
+    SNK_DRM_waitFlip(drm);
+
+    SNK_EventLoop_close(&loop);
+    SNK_Timer_close(&timer);
+    SNK_Renderer_free(&renderer);
+    SNK_WorkerPool_close(&workers);
+
+    SNK_FrameStats_print(&stats);
+
+    if (game.status == SNK_GameStatus_Lost)
+        printf("You lose! Score: %lu\n", game.score);
+    else if (game.status == SNK_GameStatus_Won)
+        printf("You win! Score: %lu\n", game.score);
+
+    if (sources.recorder != nullptr && !SNK_Recorder_close(sources.recorder))
+        printf("Failed to write recording '%s': %s\n", options->record_path, strerror(errno));
+
+    if (sources.replay != nullptr)
+        SNK_Replay_free(sources.replay);
+
+    if (sources.autopilot != nullptr)
+        SNK_Autopilot_free(sources.autopilot);
+
+    SNK_Game_free(&game);
+
 cleanup:
     SNK_Keyboard_free(&keyboard);
-    SNK_DRM_free(&drm);
+
+    // The console gets the screen back, the buffers stay around for the next game
+    if (session->_is_open && !SNK_DRM_release(&session->_drm))
+        SNK_SnakeSession_close(session);
+
     SNK_switchConsoleTo("/dev/tty0");
 }
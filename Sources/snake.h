@@ -1,3 +1,45 @@
 #pragma once
 
-void SNK_snake();
+#include "drm.h"
+#include <stdint.h>
+
+// Longest mode name, such as "1920x1080@60", that is kept around
+static constexpr size_t SNK_SNAKE_MODE_NAME_SIZE = 32;
+
+typedef struct {
+    // Use `seed` instead of a kernel-provided one, so that runs are reproducible
+    bool     has_seed;
+    uint64_t seed;
+    // Write the input of every tick to this file, so the game can be replayed
+    const char* record_path;
+    // Play back a recording made with `record_path` as fast as possible, instead of waiting for the timer
+    const char* replay_path;
+    // Let the autopilot steer, for soak runs and fill-the-board benchmarks
+    bool autopilot;
+    // Present with the legacy modesetting ioctls even if the driver supports atomic commits
+    bool legacy_kms;
+    // Flip frames without waiting for vblank, for the lowest input latency at the cost of tearing
+    bool async_flip;
+    // Render in 16-bit RGB565 to halve the memory traffic, if the display supports it
+    bool rgb565;
+    // Render one pixel per cell and have the display scale the frame up, if its primary plane can. The score line
+    // is left out.
+    bool plane_scaling;
+    // "preferred", "smallest" or a mode name such as "1280x720@60", nullptr to take snake.mode= from the kernel
+    // command line and the preferred mode without it
+    const char* mode;
+} SNK_SnakeOptions;
+
+// Display kept open between games, so that only the first one probes it and allocates and maps the framebuffers.
+// Zero initialized before the first game.
+typedef struct {
+    SNK_DRM _drm;
+    bool    _is_open;
+    // What the display was set up with, a game asking for anything else gets a new one
+    SNK_DRM_Options _options;
+    char            _mode_name[SNK_SNAKE_MODE_NAME_SIZE];
+} SNK_SnakeSession;
+
+void SNK_SnakeSession_close(SNK_SnakeSession* session);
+
+void SNK_snake(const SNK_SnakeOptions* options, SNK_SnakeSession* session);
@@ -0,0 +1,91 @@
+#include "stats.h"
+#include "utils.h"
+#include <stdio.h>
+
+const char* const _SNK_FRAME_PHASE_NAMES[SNK_FramePhase_Count] = {
+    [SNK_FramePhase_Input]   = "input",
+    [SNK_FramePhase_Tick]    = "tick",
+    [SNK_FramePhase_Render]  = "render",
+    [SNK_FramePhase_Present] = "present",
+    [SNK_FramePhase_Frame]   = "frame",
+};
+
+// Uppercase for the built-in font, which has no lowercase glyphs
+const char* const _SNK_FRAME_PHASE_LABELS[SNK_FramePhase_Count] = {
+    [SNK_FramePhase_Input]   = "IN",
+    [SNK_FramePhase_Tick]    = "TICK",
+    [SNK_FramePhase_Render]  = "DRAW",
+    [SNK_FramePhase_Present] = "FLIP",
+    [SNK_FramePhase_Frame]   = "FRAME",
+};
+
+void SNK_FrameStats_reset(SNK_FrameStats* stats) {
+    ASSERT(stats != nullptr);
+
+    for (size_t i = 0; i < SNK_FramePhase_Count; i++) {
+        SNK_Histogram_reset(&stats->_phases[i]);
+
+        stats->_window_max[i] = 0;
+    }
+
+    stats->_missed_deadlines = 0;
+}
+
+void SNK_FrameStats_record(SNK_FrameStats* stats, const SNK_FramePhase phase, const uint64_t ns) {
+    ASSERT(stats != nullptr);
+    ASSERT(phase < SNK_FramePhase_Count);
+
+    SNK_Histogram_record(&stats->_phases[phase], ns);
+
+    if (ns > stats->_window_max[phase])
+        stats->_window_max[phase] = ns;
+}
+
+void SNK_FrameStats_missDeadlines(SNK_FrameStats* stats, const uint64_t count) {
+    ASSERT(stats != nullptr);
+
+    stats->_missed_deadlines += count;
+}
+
+void SNK_FrameStats_formatLive(SNK_FrameStats* stats, char* text, const size_t size) {
+    ASSERT(stats != nullptr);
+    ASSERT(text != nullptr);
+    ASSERT(size != 0);
+
+    size_t length = 0;
+
+    text[0] = '\0';
+
+    for (size_t i = 0; i < SNK_FramePhase_Count; i++) {
+        length = SNK_appendText(text, size, length, _SNK_FRAME_PHASE_LABELS[i]);
+        length = SNK_appendText(text, size, length, " ");
+        length = SNK_appendU64(text, size, length, stats->_window_max[i] / 1000);
+        length = SNK_appendText(text, size, length, "US ");
+
+        stats->_window_max[i] = 0;
+    }
+
+    length = SNK_appendText(text, size, length, "MISS ");
+    SNK_appendU64(text, size, length, stats->_missed_deadlines);
+}
+
+void SNK_FrameStats_print(const SNK_FrameStats* stats) {
+    ASSERT(stats != nullptr);
+
+    printf("** Frame Stats **\n");
+    printf("- Frames: %llu\n", SNK_Histogram_count(&stats->_phases[SNK_FramePhase_Frame]));
+    printf("- Missed deadlines: %llu\n", stats->_missed_deadlines);
+
+    printf("** ns/phase (min, p50, p99, max) **\n");
+
+    for (size_t i = 0; i < SNK_FramePhase_Count; i++) {
+        const SNK_Histogram* histogram = &stats->_phases[i];
+
+        if (SNK_Histogram_count(histogram) == 0)
+            continue;
+
+        printf("- %s: %llu, %llu, %llu, %llu\n", _SNK_FRAME_PHASE_NAMES[i], SNK_Histogram_min(histogram),
+               SNK_Histogram_percentile(histogram, 500), SNK_Histogram_percentile(histogram, 990),
+               SNK_Histogram_max(histogram));
+    }
+}
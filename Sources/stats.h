@@ -0,0 +1,39 @@
+#pragma once
+
+#include "histogram.h"
+#include <stdint.h>
+
+// Parts of a frame that are timed separately
+typedef enum {
+    // Reading the keyboard and the replay or autopilot, once per tick
+    SNK_FramePhase_Input,
+    // Advancing the game and recording its input, once per tick
+    SNK_FramePhase_Tick,
+    SNK_FramePhase_Render,
+    // Waiting for a free buffer and handing the frame to DRM
+    SNK_FramePhase_Present,
+    // Everything a frame does between two timer wakeups
+    SNK_FramePhase_Frame,
+    SNK_FramePhase_Count,
+} SNK_FramePhase;
+
+// Timings of every frame phase in nanoseconds, recording never allocates
+typedef struct {
+    SNK_Histogram _phases[SNK_FramePhase_Count];
+    // Slowest time of each phase since the live numbers were last formatted
+    uint64_t _window_max[SNK_FramePhase_Count];
+    // Timer periods that passed without a frame
+    uint64_t _missed_deadlines;
+} SNK_FrameStats;
+
+void SNK_FrameStats_reset(SNK_FrameStats* stats);
+
+void SNK_FrameStats_record(SNK_FrameStats* stats, SNK_FramePhase phase, uint64_t ns);
+
+void SNK_FrameStats_missDeadlines(SNK_FrameStats* stats, uint64_t count);
+
+// Writes the slowest time of every phase since the last call as one line, in microseconds, and starts over
+void SNK_FrameStats_formatLive(SNK_FrameStats* stats, char* text, size_t size);
+
+// Prints min, p50, p99 and max of every phase and the missed deadlines
+void SNK_FrameStats_print(const SNK_FrameStats* stats);
@@ -0,0 +1,78 @@
+#include "timer.h"
+#include "utils.h"
+#include <linux/time_types.h>
+#include <linux/timerfd.h>
+#include <stdio.h>
+
+uint64_t SNK_Timer_now() {
+    struct timespec now;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+        SNK_crash("Failed to read monotonic clock: %s", strerror(errno));
+
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+bool SNK_Timer_open(SNK_Timer* timer, const uint64_t period_ns) {
+    ASSERT(timer != nullptr);
+    ASSERT(period_ns != 0);
+
+    const int fd = (int)syscall(__NR_timerfd_create, CLOCK_MONOTONIC, TFD_CLOEXEC);
+
+    if (fd < 0)
+        return false;
+
+    const struct __kernel_timespec period = {
+        .tv_sec  = (long long)(period_ns / 1000000000),
+        .tv_nsec = (long long)(period_ns % 1000000000),
+    };
+
+    const struct __kernel_itimerspec spec = {
+        .it_interval = period,
+        .it_value    = period,
+    };
+
+    if (syscall(__NR_timerfd_settime, fd, 0, &spec, nullptr) != 0) {
+        close(fd);
+
+        return false;
+    }
+
+    timer->_fd = fd;
+
+    return true;
+}
+
+uint64_t SNK_Timer_wait(const SNK_Timer* timer) {
+    ASSERT(timer != nullptr);
+    ASSERT(timer->_fd >= 0);
+
+    uint64_t expirations = 0;
+
+    while (true) {
+        const ssize_t bytes = read(timer->_fd, &expirations, sizeof(expirations));
+
+        if (bytes == sizeof(expirations))
+            return expirations;
+
+        if (bytes < 0 && errno == EINTR)
+            continue;
+
+        SNK_crash("Failed to read timer: %s", strerror(errno));
+    }
+}
+
+int SNK_Timer_fd(const SNK_Timer* timer) {
+    ASSERT(timer != nullptr);
+
+    return timer->_fd;
+}
+
+void SNK_Timer_close(SNK_Timer* timer) {
+    ASSERT(timer != nullptr);
+
+    if (timer->_fd >= 0) {
+        close(timer->_fd);
+        timer->_fd = -1;
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+// Current CLOCK_MONOTONIC time in nanoseconds
+uint64_t SNK_Timer_now();
+
+// Periodic CLOCK_MONOTONIC timer backed by a timerfd, deadlines don't drift with the work done between waits
+typedef struct {
+    int _fd;
+} SNK_Timer;
+
+bool SNK_Timer_open(SNK_Timer* timer, uint64_t period_ns);
+
+// Blocks until the next deadline, returns how many periods went by since the last wait
+uint64_t SNK_Timer_wait(const SNK_Timer* timer);
+
+// Readable once a deadline has passed, for an event loop to wait on instead of SNK_Timer_wait
+int SNK_Timer_fd(const SNK_Timer* timer);
+
+void SNK_Timer_close(SNK_Timer* timer);
@@ -13,6 +13,10 @@ void SNK_crash(const char* msg, ...) {
 
     printf("\n");
 
+    // Only init has a machine to reboot, tools built from the same sources just fail
+    if (getpid() != 1)
+        exit(EXIT_FAILURE);
+
     printf("Rebooting in 5 seconds...\n");
 
     sleep(5);
@@ -57,3 +61,128 @@ void SNK_switchConsoleTo(const char* path) {
     SNK_VT_setConsoleTo(&vt);
     SNK_VT_close(&vt);
 }
+
+int64_t SNK_wrap(const int64_t value, const int64_t min, const int64_t max) {
+    if (value < min)
+        return max - (min - value);
+
+    if (value >= max)
+        return min + (value - max);
+
+    return value;
+}
+
+uint64_t SNK_mulHigh64(const uint64_t a, const uint64_t b) {
+    const uint64_t a_lo = a & UINT32_MAX;
+    const uint64_t a_hi = a >> 32;
+    const uint64_t b_lo = b & UINT32_MAX;
+    const uint64_t b_hi = b >> 32;
+
+    const uint64_t lo_lo = a_lo * b_lo;
+    const uint64_t hi_lo = a_hi * b_lo;
+    const uint64_t lo_hi = a_lo * b_hi;
+    const uint64_t hi_hi = a_hi * b_hi;
+
+    // Sum of the middle column, which can't overflow as each term is below 2^32
+    const uint64_t middle = (lo_lo >> 32) + (hi_lo & UINT32_MAX) + (lo_hi & UINT32_MAX);
+
+    return hi_hi + (hi_lo >> 32) + (lo_hi >> 32) + (middle >> 32);
+}
+
+bool SNK_parseU64(const char* str, uint64_t* out) {
+    ASSERT(str != nullptr);
+    ASSERT(out != nullptr);
+
+    if (*str == '\0')
+        return false;
+
+    uint64_t value = 0;
+
+    for (; *str != '\0'; str++) {
+        if (*str < '0' || *str > '9')
+            return false;
+
+        const uint64_t digit = (uint64_t)(*str - '0');
+
+        if (value > (UINT64_MAX - digit) / 10)
+            return false;
+
+        value = value * 10 + digit;
+    }
+
+    *out = value;
+
+    return true;
+}
+
+bool SNK_kernelArg(const char* name, char* value, const size_t size) {
+    ASSERT(name != nullptr);
+    ASSERT(value != nullptr);
+    ASSERT(size != 0);
+
+    const int fd = open("/proc/cmdline", O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+        return false;
+
+    char          cmdline[4096];
+    const ssize_t bytes = read(fd, cmdline, sizeof(cmdline) - 1);
+
+    close(fd);
+
+    if (bytes <= 0)
+        return false;
+
+    cmdline[bytes] = '\0';
+
+    const size_t name_length = strlen(name);
+
+    for (char* arg = cmdline; *arg != '\0';) {
+        size_t length = 0;
+
+        while (arg[length] != '\0' && arg[length] != ' ' && arg[length] != '\n')
+            length++;
+
+        if (length > name_length && strncmp(arg, name, name_length) == 0 && arg[name_length] == '=') {
+            arg[length] = '\0';
+
+            SNK_appendText(value, size, 0, arg + name_length + 1);
+
+            return true;
+        }
+
+        arg += length;
+
+        while (*arg == ' ' || *arg == '\n')
+            arg++;
+    }
+
+    return false;
+}
+
+size_t SNK_appendText(char* buffer, const size_t size, size_t length, const char* text) {
+    ASSERT(buffer != nullptr);
+    ASSERT(text != nullptr);
+    ASSERT(length < size);
+
+    for (; *text != '\0' && length + 1 < size; text++)
+        buffer[length++] = *text;
+
+    buffer[length] = '\0';
+
+    return length;
+}
+
+size_t SNK_appendU64(char* buffer, const size_t size, const size_t length, uint64_t value) {
+    char   digits[21];
+    size_t start = sizeof(digits) - 1;
+
+    digits[start] = '\0';
+
+    do {
+        digits[--start] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    return SNK_appendText(buffer, size, length, digits + start);
+}
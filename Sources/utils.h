@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 #define ARRSIZE(arr) (sizeof(arr) / sizeof(arr[0]))
 
 #define ASSERT(x)                                                                                                      \
@@ -14,3 +16,19 @@ bool SNK_exists(const char* path);
 bool SNK_isDir(const char* path);
 
 void SNK_switchConsoleTo(const char* path);
+
+int64_t SNK_wrap(int64_t value, int64_t min, int64_t max);
+
+bool SNK_parseU64(const char* str, uint64_t* out);
+
+// High 64 bits of the 128-bit product `a * b`, from 32-bit halves since 32-bit targets have no 128-bit integers
+uint64_t SNK_mulHigh64(uint64_t a, uint64_t b);
+
+// Copies the value of `name=VALUE` on the kernel command line into `value`, returns false if there is none
+bool SNK_kernelArg(const char* name, char* value, size_t size);
+
+// Appends `text` to the string of `length` characters in `buffer`, cutting it off at the end, returns the new length
+size_t SNK_appendText(char* buffer, size_t size, size_t length, const char* text);
+
+// Same as SNK_appendText for the decimal digits of `value`
+size_t SNK_appendU64(char* buffer, size_t size, size_t length, uint64_t value);
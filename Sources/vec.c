@@ -80,6 +80,12 @@ void* SNK_Vec_at(const SNK_Vec* vec, const size_t index) {
     return (char*)vec->_data + index * vec->_elem_size;
 }
 
+void SNK_Vec_clear(SNK_Vec* vec) {
+    ASSERT(vec != nullptr);
+
+    vec->_size = 0;
+}
+
 void SNK_Vec_free(SNK_Vec* vec) {
     ASSERT(vec != nullptr);
 
@@ -92,3 +98,107 @@ void SNK_Vec_free(SNK_Vec* vec) {
     vec->_elem_size = 0;
     vec->_size      = 0;
 }
+
+SNK_Ring SNK_Ring_new(const size_t capacity, const size_t elem_size) {
+    ASSERT(capacity != 0);
+
+    void* data = malloc(capacity * elem_size);
+
+    if (data == nullptr)
+        SNK_crash("Failed to allocate memory for ring");
+
+    return (SNK_Ring){
+        ._data      = data,
+        ._head      = 0,
+        ._size      = 0,
+        ._capacity  = capacity,
+        ._elem_size = elem_size,
+    };
+}
+
+size_t SNK_Ring_size(const SNK_Ring* ring) {
+    ASSERT(ring != nullptr);
+
+    return ring->_size;
+}
+
+size_t SNK_Ring_capacity(const SNK_Ring* ring) {
+    ASSERT(ring != nullptr);
+
+    return ring->_capacity;
+}
+
+size_t _SNK_Ring_slot(const SNK_Ring* ring, const size_t index) {
+    const size_t slot = ring->_head + index;
+
+    return slot >= ring->_capacity ? slot - ring->_capacity : slot;
+}
+
+void _SNK_Ring_grow(SNK_Ring* ring) {
+    const size_t new_capacity = ring->_capacity * 2;
+    char*        data         = malloc(new_capacity * ring->_elem_size);
+
+    if (data == nullptr)
+        SNK_crash("Failed to reallocate memory for ring");
+
+    // Unwrap the elements so the front lands at slot 0 of the new storage
+    const size_t first_part = ring->_capacity - ring->_head;
+
+    memcpy(data, (char*)ring->_data + ring->_head * ring->_elem_size, first_part * ring->_elem_size);
+    memcpy(data + first_part * ring->_elem_size, ring->_data, ring->_head * ring->_elem_size);
+
+    free(ring->_data);
+
+    ring->_data     = data;
+    ring->_head     = 0;
+    ring->_capacity = new_capacity;
+}
+
+void SNK_Ring_pushFront(SNK_Ring* ring, const void* elem, const size_t elem_size) {
+    ASSERT(ring != nullptr);
+    ASSERT(elem != nullptr);
+    ASSERT(elem_size == ring->_elem_size);
+
+    if (ring->_size == ring->_capacity)
+        _SNK_Ring_grow(ring);
+
+    ring->_head = ring->_head == 0 ? ring->_capacity - 1 : ring->_head - 1;
+
+    memcpy((char*)ring->_data + ring->_head * ring->_elem_size, elem, elem_size);
+    ring->_size++;
+}
+
+void SNK_Ring_popBack(SNK_Ring* ring, void* out_elem) {
+    ASSERT(ring != nullptr);
+    ASSERT(ring->_size != 0);
+
+    if (out_elem != nullptr) {
+        memcpy(out_elem, (char*)ring->_data + _SNK_Ring_slot(ring, ring->_size - 1) * ring->_elem_size,
+               ring->_elem_size);
+    }
+
+    ring->_size--;
+}
+
+void* SNK_Ring_at(const SNK_Ring* ring, const size_t index) {
+    ASSERT(ring != nullptr);
+
+    if (index >= ring->_size)
+        return nullptr;
+
+    return (char*)ring->_data + _SNK_Ring_slot(ring, index) * ring->_elem_size;
+}
+
+void SNK_Ring_free(SNK_Ring* ring) {
+    ASSERT(ring != nullptr);
+
+    if (ring->_data != nullptr) {
+        free(ring->_data);
+    }
+
+    ring->_data      = nullptr;
+    ring->_head      = 0;
+    ring->_capacity  = 0;
+    ring->_elem_size = 0;
+    ring->_size      = 0;
+}
@@ -23,4 +23,28 @@ void SNK_Vec_remove(SNK_Vec* vec, size_t index, void* out_elem);
 
 void* SNK_Vec_at(const SNK_Vec* vec, size_t index);
 
+void SNK_Vec_clear(SNK_Vec* vec);
+
 void SNK_Vec_free(SNK_Vec* vec);
+
+typedef struct {
+    void*  _data;
+    size_t _head;
+    size_t _size;
+    size_t _capacity;
+    size_t _elem_size;
+} SNK_Ring;
+
+SNK_Ring SNK_Ring_new(size_t capacity, size_t elem_size);
+
+size_t SNK_Ring_size(const SNK_Ring* ring);
+
+size_t SNK_Ring_capacity(const SNK_Ring* ring);
+
+void SNK_Ring_pushFront(SNK_Ring* ring, const void* elem, size_t elem_size);
+
+void SNK_Ring_popBack(SNK_Ring* ring, void* out_elem);
+
+void* SNK_Ring_at(const SNK_Ring* ring, size_t index);
+
+void SNK_Ring_free(SNK_Ring* ring);
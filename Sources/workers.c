@@ -0,0 +1,251 @@
+#include "workers.h"
+#include "utils.h"
+#include <linux/futex.h>
+#include <linux/sched.h>
+#include <stdio.h>
+
+constexpr size_t _SNK_WORKER_STACK_SIZE = 64 * 1024;
+
+struct _SNK_Worker {
+    SNK_WorkerPool* pool;
+    void*           stack;
+    // Cleared by the kernel with a futex wake when the thread exits, see CLONE_CHILD_CLEARTID
+    uint32_t tid;
+};
+
+void _SNK_futexWait(uint32_t* word, const uint32_t expected) {
+    syscall(__NR_futex, word, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+// The kernel wakes the CLONE_CHILD_CLEARTID word with a shared futex, so the private wait would never see it
+void _SNK_futexWaitShared(uint32_t* word, const uint32_t expected) {
+    syscall(__NR_futex, word, FUTEX_WAIT, expected, nullptr, nullptr, 0);
+}
+
+void _SNK_futexWake(uint32_t* word) { syscall(__NR_futex, word, FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0); }
+
+// Starts `entry(arg)` on a new thread with its stack ending at `stack_top`, the thread exits when entry returns.
+// Returns the thread ID or a negated errno, the raw syscall leaves errno alone.
+// The child can't return into C code on a fresh stack, so it pops its entry point and calls it from assembly.
+long _SNK_clone(const unsigned long flags, void* stack_top, void (*entry)(void*), void* arg, uint32_t* tid) {
+    ASSERT(((uintptr_t)stack_top & 15) == 0);
+
+    void** sp = (void**)stack_top - 2;
+
+    sp[0] = (void*)entry;
+    sp[1] = arg;
+
+#if defined(__x86_64__)
+    long                   result;
+    register unsigned long r10 __asm__("r10") = (unsigned long)tid;
+    register unsigned long r8 __asm__("r8")   = 0;
+
+    __asm__ volatile("syscall\n"
+                     "test %%rax, %%rax\n"
+                     "jnz 1f\n"
+                     "pop %%rax\n"
+                     "pop %%rdi\n"
+                     "call *%%rax\n"
+                     "mov %[exit], %%eax\n"
+                     "xor %%edi, %%edi\n"
+                     "syscall\n"
+                     "1:\n"
+                     : "=a"(result)
+                     : "a"(__NR_clone), "D"(flags), "S"(sp), "d"(0), "r"(r10), "r"(r8), [exit] "i"(__NR_exit)
+                     : "rcx", "r11", "memory");
+
+    return result;
+#elif defined(__aarch64__)
+    register long x0 __asm__("x0") = (long)flags;
+    register long x1 __asm__("x1") = (long)sp;
+    register long x2 __asm__("x2") = 0;
+    register long x3 __asm__("x3") = 0;
+    register long x4 __asm__("x4") = (long)tid;
+    register long x8 __asm__("x8") = __NR_clone;
+
+    __asm__ volatile("svc #0\n"
+                     "cbnz x0, 1f\n"
+                     "ldp x1, x0, [sp], #16\n"
+                     "blr x1\n"
+                     "mov x8, %[exit]\n"
+                     "mov x0, #0\n"
+                     "svc #0\n"
+                     "1:\n"
+                     : "+r"(x0)
+                     : "r"(x1), "r"(x2), "r"(x3), "r"(x4), "r"(x8), [exit] "i"(__NR_exit)
+                     : "memory");
+
+    return x0;
+#else
+    // SNK_WorkerPool_open starts no threads here, the callers run every part themselves
+    return -ENOSYS;
+#endif
+}
+
+// Runs parts of the current job until there are none left
+void _SNK_WorkerPool_work(SNK_WorkerPool* pool) {
+    while (true) {
+        const size_t part = __atomic_fetch_add(&pool->_next_part, 1, __ATOMIC_RELAXED);
+
+        if (part >= pool->_part_count)
+            break;
+
+        pool->_job(pool->_context, part, pool->_part_count);
+    }
+}
+
+void _SNK_Worker_main(void* arg) {
+    const auto      worker = (_SNK_Worker*)arg;
+    SNK_WorkerPool* pool   = worker->pool;
+
+    uint32_t generation = 0;
+
+    while (true) {
+        uint32_t current;
+
+        while ((current = __atomic_load_n(&pool->_generation, __ATOMIC_ACQUIRE)) == generation)
+            _SNK_futexWait(&pool->_generation, generation);
+
+        generation = current;
+
+        if (pool->_is_stopping)
+            return;
+
+        _SNK_WorkerPool_work(pool);
+
+        if (__atomic_sub_fetch(&pool->_busy, 1, __ATOMIC_ACQ_REL) == 0)
+            _SNK_futexWake(&pool->_busy);
+    }
+}
+
+size_t SNK_WorkerPool_cpuCount() {
+    uint64_t  mask[16] = {};
+    const int bytes    = (int)syscall(__NR_sched_getaffinity, 0, sizeof(mask), mask);
+
+    if (bytes <= 0)
+        return 1;
+
+    size_t count = 0;
+
+    for (size_t i = 0; i < (size_t)bytes / sizeof(uint64_t); i++)
+        count += __builtin_popcountll(mask[i]);
+
+    return count != 0 ? count : 1;
+}
+
+bool SNK_WorkerPool_open(SNK_WorkerPool* pool, size_t thread_count) {
+    ASSERT(pool != nullptr);
+
+    if (thread_count > SNK_WORKER_POOL_MAX_THREADS)
+        thread_count = SNK_WORKER_POOL_MAX_THREADS;
+
+    *pool = (SNK_WorkerPool){};
+
+#if !defined(__x86_64__) && !defined(__aarch64__)
+    // No clone trampoline for this architecture, an empty pool still runs jobs on the calling thread
+    thread_count = 0;
+#endif
+
+    if (thread_count == 0)
+        return true;
+
+    pool->_workers = calloc(thread_count, sizeof(_SNK_Worker));
+
+    if (pool->_workers == nullptr)
+        SNK_crash("Failed to allocate workers");
+
+    const unsigned long flags = CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND | CLONE_THREAD | CLONE_SYSVSEM |
+                                CLONE_CHILD_CLEARTID;
+
+    for (size_t i = 0; i < thread_count; i++) {
+        _SNK_Worker* worker = &pool->_workers[i];
+
+        worker->pool  = pool;
+        worker->stack = mmap(nullptr, _SNK_WORKER_STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                             -1, 0);
+
+        if (worker->stack == MAP_FAILED) {
+            printf("Failed to allocate worker stack: %s\n", strerror(errno));
+
+            SNK_WorkerPool_close(pool);
+
+            return false;
+        }
+
+        // Non-zero until the kernel clears it on exit
+        worker->tid = 1;
+
+        const long result =
+            _SNK_clone(flags, (uint8_t*)worker->stack + _SNK_WORKER_STACK_SIZE, _SNK_Worker_main, worker, &worker->tid);
+
+        if (result < 0) {
+            printf("Failed to start worker: %s\n", strerror((int)-result));
+
+            munmap(worker->stack, _SNK_WORKER_STACK_SIZE);
+            SNK_WorkerPool_close(pool);
+
+            return false;
+        }
+
+        pool->_thread_count++;
+    }
+
+    return true;
+}
+
+size_t SNK_WorkerPool_threadCount(const SNK_WorkerPool* pool) {
+    ASSERT(pool != nullptr);
+
+    return pool->_thread_count;
+}
+
+void SNK_WorkerPool_run(SNK_WorkerPool* pool, const SNK_WorkerPool_Job job, void* context, const size_t part_count) {
+    ASSERT(pool != nullptr);
+    ASSERT(job != nullptr);
+
+    pool->_job        = job;
+    pool->_context    = context;
+    pool->_part_count = part_count;
+    pool->_next_part  = 0;
+
+    if (pool->_thread_count != 0) {
+        __atomic_store_n(&pool->_busy, (uint32_t)pool->_thread_count, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&pool->_generation, 1, __ATOMIC_RELEASE);
+        _SNK_futexWake(&pool->_generation);
+    }
+
+    _SNK_WorkerPool_work(pool);
+
+    uint32_t busy;
+
+    while ((busy = __atomic_load_n(&pool->_busy, __ATOMIC_ACQUIRE)) != 0)
+        _SNK_futexWait(&pool->_busy, busy);
+}
+
+void SNK_WorkerPool_close(SNK_WorkerPool* pool) {
+    ASSERT(pool != nullptr);
+
+    if (pool->_workers == nullptr)
+        return;
+
+    pool->_is_stopping = true;
+
+    __atomic_add_fetch(&pool->_generation, 1, __ATOMIC_RELEASE);
+    _SNK_futexWake(&pool->_generation);
+
+    for (size_t i = 0; i < pool->_thread_count; i++) {
+        _SNK_Worker* worker = &pool->_workers[i];
+
+        uint32_t tid;
+
+        // The stack is only safe to unmap once the kernel is done with the thread
+        while ((tid = __atomic_load_n(&worker->tid, __ATOMIC_ACQUIRE)) != 0)
+            _SNK_futexWaitShared(&worker->tid, tid);
+
+        munmap(worker->stack, _SNK_WORKER_STACK_SIZE);
+    }
+
+    free(pool->_workers);
+
+    *pool = (SNK_WorkerPool){};
+}
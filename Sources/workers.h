@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+// Most threads a pool starts, besides the thread that runs the jobs
+static constexpr size_t SNK_WORKER_POOL_MAX_THREADS = 7;
+
+// Runs part `index` of `count` parts of a job
+typedef void (*SNK_WorkerPool_Job)(void* context, size_t index, size_t count);
+
+typedef struct _SNK_Worker _SNK_Worker;
+
+// Threads started with raw clone() and parked on futexes, nolibc has no pthreads.
+// The workers point back at the pool, so it must not move between open and close.
+typedef struct {
+    _SNK_Worker* _workers;
+    size_t       _thread_count;
+    // Bumped to hand the workers a new job or to stop them
+    uint32_t _generation;
+    // Workers still busy with the current job
+    uint32_t           _busy;
+    size_t             _next_part;
+    SNK_WorkerPool_Job _job;
+    void*              _context;
+    size_t             _part_count;
+    bool               _is_stopping;
+} SNK_WorkerPool;
+
+// Online CPUs this process may run on
+size_t SNK_WorkerPool_cpuCount();
+
+// Starts `thread_count` workers, 0 runs every job on the calling thread
+bool SNK_WorkerPool_open(SNK_WorkerPool* pool, size_t thread_count);
+
+size_t SNK_WorkerPool_threadCount(const SNK_WorkerPool* pool);
+
+// Splits the job into `part_count` parts run by the workers and the calling thread, returns once all are done
+void SNK_WorkerPool_run(SNK_WorkerPool* pool, SNK_WorkerPool_Job job, void* context, size_t part_count);
+
+void SNK_WorkerPool_close(SNK_WorkerPool* pool);